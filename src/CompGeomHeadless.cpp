@@ -0,0 +1,196 @@
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Image.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#ifdef COMP_GEOM_WINDOWLESS_GLX
+#include <Magnum/Platform/WindowlessGlxApplication.h>
+#else
+#include <Magnum/Platform/WindowlessEglApplication.h>
+#endif
+
+#include "core/CompGeomCore.h"
+#include "render/GeometryRenderer.h"
+
+using namespace Magnum;
+using namespace CompGeom;
+
+// Renders geometry files into an offscreen framebuffer and writes each one
+// to an image, without a window or display. All inputs share one GL
+// context, so a batch pays for its creation once. Under Mesa, EGL picks
+// llvmpipe when there's no GPU.
+class CompGeomHeadless : public Platform::WindowlessApplication {
+  public:
+    explicit CompGeomHeadless(const Arguments& arguments);
+
+    int exec() override;
+
+  private:
+    // Draws one file into the bound framebuffer, false if it can't be read.
+    bool render(const std::string& input);
+    bool write(const Image2D& image, const std::string& path);
+
+    Utility::Arguments args_;
+    Vector2i size_;
+    std::string format_;
+    Containers::Pointer<GeometryRenderer> renderer_;
+    PluginManager::Manager<Trade::AbstractImageConverter> converters_;
+    Containers::Pointer<Trade::AbstractImageConverter> png_;
+};
+
+CompGeomHeadless::CompGeomHeadless(const Arguments& arguments)
+    : Platform::WindowlessApplication{arguments} {
+    args_.addArrayArgument("input")
+        .setHelp("input", "geometry files of points or segments", "FILE")
+        .addOption("output", ".")
+        .setHelp("output", "directory to write the images to")
+        .addOption("format", "png")
+        .setHelp("format", "png, or raw for bottom-up RGBA8 rows")
+        .addOption("size", "1024 1024")
+        .setHelp("size", "image size in pixels", "\"X Y\"")
+        .addSkippedPrefix("magnum", "engine-specific options")
+        .setGlobalHelp(
+            "Renders the hull of point files, and the segments and their\n"
+            "intersections of segment files, into one image per input.")
+        .parse(arguments.argc, arguments.argv);
+    size_ = args_.value<Vector2i>("size");
+    format_ = args_.value("format");
+}
+
+int CompGeomHeadless::exec() {
+    if (format_ != "png" && format_ != "raw") {
+        Error{} << "Unknown format" << format_;
+        return 1;
+    }
+    if (format_ == "png") {
+        png_ = converters_.loadAndInstantiate("PngImageConverter");
+        if (!png_)
+            return 1;
+    }
+
+    GL::Renderbuffer color, depth;
+    color.setStorage(GL::RenderbufferFormat::RGBA8, size_);
+    depth.setStorage(GL::RenderbufferFormat::DepthComponent24, size_);
+    GL::Framebuffer framebuffer{{{}, size_}};
+    framebuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, color)
+        .attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth, depth);
+    if (framebuffer.checkStatus(GL::FramebufferTarget::Draw) !=
+        GL::Framebuffer::Status::Complete) {
+        Error{} << "Can't create a" << size_ << "framebuffer";
+        return 1;
+    }
+    framebuffer.bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+    GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+    renderer_.reset(new GeometryRenderer{size_});
+
+    int failed = 0;
+    for (std::size_t i = 0; i != args_.arrayValueCount("input"); ++i) {
+        const std::string input = args_.arrayValue("input", i);
+        framebuffer.clear(GL::FramebufferClear::Color |
+                          GL::FramebufferClear::Depth);
+        if (!render(input)) {
+            ++failed;
+            continue;
+        }
+        const std::string name = Utility::Directory::splitExtension(
+                                     Utility::Directory::filename(input))
+                                     .first;
+        const std::string path = Utility::Directory::join(
+            args_.value("output"), name + "." + format_);
+        if (!write(framebuffer.read(framebuffer.viewport(),
+                                    {PixelFormat::RGBA8Unorm}),
+                   path))
+            ++failed;
+    }
+    return failed ? 1 : 0;
+}
+
+bool CompGeomHeadless::render(const std::string& input) {
+    Containers::Optional<MappedGeometryFile> file =
+        MappedGeometryFile::open(input);
+    if (!file)
+        return false;
+
+    // Double files are rounded to float for drawing.
+    std::vector<Vector2> points;
+    std::vector<Seg2> segments;
+    if (file->kind() == GeometryFileKind::Points) {
+        if (file->scalar() == GeometryFileScalar::Double) {
+            for (const Vector2d& p : file->pointsDouble())
+                points.push_back(Vector2{p});
+        } else {
+            points.assign(file->points().begin(), file->points().end());
+        }
+    } else {
+        if (file->scalar() == GeometryFileScalar::Double) {
+            const auto endpoints = file->segmentEndpointsDouble();
+            for (std::size_t i = 0; i + 1 < endpoints.size(); i += 2)
+                segments.emplace_back(Vector2{endpoints[i]},
+                                      Vector2{endpoints[i + 1]});
+        } else {
+            segments.assign(file->segments().begin(),
+                            file->segments().end());
+        }
+        for (const Seg2& seg : segments) {
+            points.push_back(seg.p);
+            points.push_back(seg.q);
+        }
+    }
+
+    Vector2 min{0.0f}, max{1.0f};
+    if (!points.empty()) {
+        min = max = points[0];
+        for (const Vector2& p : points) {
+            min = Math::min(min, p);
+            max = Math::max(max, p);
+        }
+    }
+    renderer_->setView(min, max);
+    renderer_->renderAxis();
+    if (segments.empty()) {
+        if (points.size() > LodMaxPoints)
+            renderer_->renderPointsLod(points, DensityPyramid{points},
+                                       Color3(1.0f, 1.0f, 1.0f));
+        else
+            renderer_->renderPoints(points, Color3(1.0f, 1.0f, 1.0f));
+        renderer_->renderPolyLine(computeConvexHull2D(points),
+                                  Color3(0.0f, 0.5f, 1.0f));
+    } else {
+        renderer_->renderSegs2(segments, Color3(0.5f, 0.5f, 0.5f));
+        const std::vector<Vector2> intersections =
+            findIntersectingSegmentsSweep(segments);
+        if (intersections.size() > LodMaxPoints)
+            renderer_->renderPointsLod(intersections,
+                                       DensityPyramid{intersections},
+                                       Color3(1.0f, 0.0f, 0.0f));
+        else
+            renderer_->renderPoints(intersections, Color3(1.0f, 0.0f, 0.0f));
+    }
+    return true;
+}
+
+bool CompGeomHeadless::write(const Image2D& image, const std::string& path) {
+    const bool written = png_ ? png_->exportToFile(image, path)
+                              : Utility::Directory::write(path, image.data());
+    if (!written)
+        Error{} << "Can't write" << path;
+    return written;
+}
+
+MAGNUM_WINDOWLESSAPPLICATION_MAIN(CompGeomHeadless)
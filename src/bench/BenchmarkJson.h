@@ -0,0 +1,70 @@
+#ifndef COMP_GEOM_BENCH_BENCHMARKJSON_H
+#define COMP_GEOM_BENCH_BENCHMARKJSON_H
+
+#include <cstdio>
+#include <string>
+
+namespace CompGeom {
+
+// The JSON the benchmarks write with --json, built as a string so entries
+// of any length fit.
+
+inline std::string jsonString(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+// Nine significant digits round-trip the timings; %.9g never needs more
+// than 16 characters.
+inline std::string jsonNumber(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+// One object of "key": value members on a single line.
+class JsonObject {
+  public:
+    JsonObject& addString(const char* key, const std::string& value) {
+        return addValue(key, jsonString(value));
+    }
+    JsonObject& addNumber(const char* key, double value) {
+        return addValue(key, jsonNumber(value));
+    }
+    JsonObject& addInteger(const char* key, unsigned long long value) {
+        return addValue(key, std::to_string(value));
+    }
+
+    std::string str() const { return "{" + members_ + "}"; }
+
+  private:
+    JsonObject& addValue(const char* key, const std::string& value) {
+        if (!members_.empty())
+            members_ += ", ";
+        members_ += jsonString(key) + ": " + value;
+        return *this;
+    }
+
+    std::string members_;
+};
+
+// Writes the file, printing why to stderr if it can't.
+inline bool writeJson(const std::string& path, const std::string& json) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file || std::fputs(json.c_str(), file) < 0) {
+        std::fprintf(stderr, "Can't write %s\n", path.c_str());
+        if (file)
+            std::fclose(file);
+        return false;
+    }
+    return std::fclose(file) == 0;
+}
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <Corrade/Utility/Arguments.h>
+
+#include "bench/BenchmarkJson.h"
+#include "examples/BulletWorld.h"
+
+using namespace Magnum;
+using namespace CompGeom;
+
+namespace {
+
+// Bullet's heap, counted by routing its allocations through here. Every
+// block is prefixed with its size so frees can be subtracted.
+constexpr std::size_t AllocationHeader = 16;
+std::atomic<std::size_t> bulletBytes{0};
+std::atomic<std::size_t> bulletPeakBytes{0};
+
+void* bulletAlloc(std::size_t size) {
+    auto* block = static_cast<char*>(std::malloc(size + AllocationHeader));
+    if (!block)
+        return nullptr;
+    *reinterpret_cast<std::size_t*>(block) = size;
+    const std::size_t bytes = bulletBytes += size;
+    std::size_t peak = bulletPeakBytes;
+    while (bytes > peak && !bulletPeakBytes.compare_exchange_weak(peak, bytes))
+        ;
+    return block + AllocationHeader;
+}
+
+void bulletFree(void* memory) {
+    if (!memory)
+        return;
+    char* block = static_cast<char*>(memory) - AllocationHeader;
+    bulletBytes -= *reinterpret_cast<std::size_t*>(block);
+    std::free(block);
+}
+
+// Peak resident set size of the whole process so far, 0 where unknown.
+std::size_t peakRssBytes() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return std::size_t(usage.ru_maxrss);
+#else
+    return std::size_t(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+template <class T> std::vector<T> parseList(const std::string& value) {
+    std::vector<T> list;
+    std::istringstream in{value};
+    for (T item; in >> item;)
+        list.push_back(item);
+    return list;
+}
+
+struct Result {
+    int bodies;
+    int threads;
+    int steps;
+    double seconds;
+    // Step latencies in milliseconds.
+    double p50, p90, p99, max;
+    // Per step averages of the dispatcher's persistent manifolds, one per
+    // overlapping pair, and of the contact points in them.
+    double contactPairs;
+    double contactPoints;
+    std::size_t bulletPeakBytes;
+    std::size_t peakRssBytes;
+};
+
+// Without BulletIntegration, which only the example links.
+btVector3 toBullet(const Vector3& v) { return btVector3(v.x(), v.y(), v.z()); }
+
+// Drops the box stack of the Bullet example with the given number of boxes
+// and steps it at 60 Hz, one substep per call, as fast as it goes. At least
+// one step. Like in the example every body stays awake, unless allowSleep
+// is set. The bodies have plain btDefaultMotionStates, so unlike in the
+// example no scene graph is updated after each step.
+Result run(int bodies, int threads, const std::string& scheduler, int steps,
+           int warmup, bool allowSleep) {
+    bulletPeakBytes = bulletBytes.load();
+    Result result{};
+    result.bodies = bodies;
+    result.threads = threads;
+    result.steps = steps;
+
+    Examples::BulletWorld bullet{threads, scheduler};
+    btDiscreteDynamicsWorld& world = bullet.world();
+
+    // The smallest cube of boxes holding them all, filled layer by layer
+    // from the ground up.
+    int stack = 1;
+    while (stack * stack * stack < bodies)
+        ++stack;
+    btBoxShape groundShape{toBullet(Examples::boxStackGroundHalfSize(stack))};
+    btBoxShape boxShape{{0.5f, 0.5f, 0.5f}};
+    btVector3 boxInertia{0.0f, 0.0f, 0.0f};
+    boxShape.calculateLocalInertia(1.0f, boxInertia);
+
+    std::vector<std::unique_ptr<btDefaultMotionState>> motionStates;
+    std::vector<std::unique_ptr<btRigidBody>> rigidBodies;
+    const auto addBody = [&](float mass, btCollisionShape& shape,
+                             const btVector3& inertia,
+                             const Vector3& position) {
+        btTransform transform;
+        transform.setIdentity();
+        transform.setOrigin(toBullet(position));
+        motionStates.emplace_back(new btDefaultMotionState{transform});
+        rigidBodies.emplace_back(new btRigidBody{
+            btRigidBody::btRigidBodyConstructionInfo{
+                mass, motionStates.back().get(), &shape, inertia}});
+        if (!allowSleep)
+            rigidBodies.back()->forceActivationState(DISABLE_DEACTIVATION);
+        world.addRigidBody(rigidBodies.back().get());
+    };
+    addBody(0.0f, groundShape, btVector3{0.0f, 0.0f, 0.0f}, Vector3{});
+    for (int n = 0; n != bodies; ++n) {
+        const int layer = n / (stack * stack);
+        const int row = n / stack % stack;
+        addBody(1.0f, boxShape, boxInertia,
+                Examples::boxStackPosition(stack, row, layer, n % stack));
+    }
+
+    const float timeStep = 1.0f / 60.0f;
+    for (int step = 0; step != warmup; ++step)
+        world.stepSimulation(timeStep, 1, timeStep);
+
+    std::vector<double> latencies(std::size_t(steps), 0.0);
+    btCollisionDispatcher& dispatcher = bullet.dispatcher();
+    std::size_t pairs = 0, points = 0;
+    for (int step = 0; step != steps; ++step) {
+        const auto start = std::chrono::steady_clock::now();
+        world.stepSimulation(timeStep, 1, timeStep);
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        latencies[std::size_t(step)] = elapsed.count();
+        result.seconds += elapsed.count() / 1000.0;
+
+        const int manifolds = dispatcher.getNumManifolds();
+        pairs += std::size_t(manifolds);
+        for (int i = 0; i != manifolds; ++i)
+            points += std::size_t(
+                dispatcher.getManifoldByIndexInternal(i)->getNumContacts());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&](double p) {
+        return latencies[std::min(latencies.size() - 1,
+                                  std::size_t(p * double(steps)))];
+    };
+    result.p50 = percentile(0.5);
+    result.p90 = percentile(0.9);
+    result.p99 = percentile(0.99);
+    result.max = latencies.back();
+    result.contactPairs = double(pairs) / steps;
+    result.contactPoints = double(points) / steps;
+
+    // The world keeps pointers to the bodies, so they go first.
+    for (const std::unique_ptr<btRigidBody>& body : rigidBodies)
+        world.removeRigidBody(body.get());
+    result.bulletPeakBytes = bulletPeakBytes;
+    result.peakRssBytes = peakRssBytes();
+    return result;
+}
+
+} // namespace
+
+// Steps the Bullet example's world without a window or GL context, for
+// every combination of --bodies and --threads, and reports the throughput,
+// step latency percentiles, contact pairs and memory of each.
+int main(int argc, char** argv) {
+    // Before Bullet allocates anything, so every block is counted.
+    btAlignedAllocSetCustom(bulletAlloc, bulletFree);
+
+    Utility::Arguments args;
+    args.addOption("bodies", "125 1000 8000")
+        .setHelp("bodies", "dynamic box counts to run", "\"N...\"")
+        .addOption("threads", "0 1 2 4")
+        .setHelp("threads", "thread counts to run, 0 for the single-threaded "
+                            "world", "\"N...\"")
+        .addOption("scheduler", "default")
+        .setHelp("scheduler", "task scheduler of the multi-threaded world, "
+                              "default, openmp, tbb or ppl")
+        .addOption("steps", "1000")
+        .setHelp("steps", "timed steps per run")
+        .addOption("warmup", "10")
+        .setHelp("warmup", "untimed steps before them")
+        .addBooleanOption("sleep")
+        .setHelp("sleep", "let resting bodies deactivate, the example keeps "
+                          "them all awake")
+        .addOption("json", "")
+        .setHelp("json", "file to write the results to as JSON")
+        .addOption("label", "")
+        .setHelp("label", "label stored in the JSON, like a commit hash")
+        .setGlobalHelp(
+            "Headless physics throughput benchmark. Peak RSS is of the\n"
+            "whole process, so it only grows from one run to the next;\n"
+            "Bullet's own peak heap is per run.")
+        .parse(argc, argv);
+
+    const std::vector<int> bodyCounts = parseList<int>(args.value("bodies"));
+    const std::vector<int> threadCounts =
+        parseList<int>(args.value("threads"));
+    const std::string scheduler = args.value("scheduler");
+    const int steps = std::max(1, args.value<int>("steps"));
+    const int warmup = std::max(0, args.value<int>("warmup"));
+    const bool allowSleep = args.isSet("sleep");
+
+    std::printf("%8s %7s %10s %8s %8s %8s %8s %9s %10s %10s %10s\n", "bodies",
+                "threads", "steps/s", "p50 ms", "p90 ms", "p99 ms", "max ms",
+                "pairs", "contacts", "bullet MB", "rss MB");
+    std::string json = "{\n  \"label\": " + jsonString(args.value("label")) +
+                       ",\n  \"scheduler\": " + jsonString(scheduler) +
+                       ",\n  \"sleep\": " + (allowSleep ? "true" : "false") +
+                       ",\n  \"benchmarks\": [";
+    for (const int bodies : bodyCounts) {
+        for (const int threads : threadCounts) {
+            const Result r =
+                run(std::max(0, bodies), std::max(0, threads), scheduler,
+                    steps, warmup, allowSleep);
+            std::printf("%8d %7d %10.1f %8.3f %8.3f %8.3f %8.3f %9.1f %10.1f "
+                        "%10.1f %10.1f\n",
+                        r.bodies, r.threads, r.steps / r.seconds, r.p50,
+                        r.p90, r.p99, r.max, r.contactPairs, r.contactPoints,
+                        r.bulletPeakBytes / 1048576.0,
+                        r.peakRssBytes / 1048576.0);
+            std::fflush(stdout);
+
+            json += json.back() == '[' ? "\n    " : ",\n    ";
+            json += JsonObject{}
+                        .addString("name",
+                                   "bullet/" + std::to_string(r.bodies) +
+                                       "/" + std::to_string(r.threads))
+                        .addInteger("bodies", r.bodies)
+                        .addInteger("threads", r.threads)
+                        .addInteger("steps", r.steps)
+                        .addNumber("seconds", r.seconds)
+                        .addNumber("steps_per_second", r.steps / r.seconds)
+                        .addNumber("p50_ms", r.p50)
+                        .addNumber("p90_ms", r.p90)
+                        .addNumber("p99_ms", r.p99)
+                        .addNumber("max_ms", r.max)
+                        .addNumber("contact_pairs", r.contactPairs)
+                        .addNumber("contact_points", r.contactPoints)
+                        .addInteger("bullet_peak_bytes", r.bulletPeakBytes)
+                        .addInteger("peak_rss_bytes", r.peakRssBytes)
+                        .str();
+        }
+    }
+    json += "\n  ]\n}\n";
+
+    const std::string path = args.value("json");
+    if (!path.empty() && !writeJson(path, json))
+        return 1;
+
+    return 0;
+}
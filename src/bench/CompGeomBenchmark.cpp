@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <Corrade/Utility/Arguments.h>
+
+#include "bench/BenchmarkJson.h"
+#include "core/CompGeomCore.h"
+
+using namespace Magnum;
+using namespace CompGeom;
+
+// Every allocation of the process goes through here, so runs can report
+// how many allocations and bytes one operation needs.
+namespace {
+std::atomic<std::size_t> allocationCount{0};
+std::atomic<std::size_t> allocationBytes{0};
+} // namespace
+
+// GCC takes free() inside the replaced operator delete for a mismatch once
+// it inlines both into a new expression.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    allocationBytes += size;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+// One routine run on one input. Returns the size of its result, the hull
+// vertex or intersection count, so the work can't be optimized away and
+// runs on different commits can be checked for the same answer.
+struct Benchmark {
+    std::string routine;
+    std::string distribution;
+    std::size_t size;
+    std::function<std::size_t()> run;
+    // Untimed setup done once before the runs, like building a tree that
+    // run() only queries.
+    std::function<void()> prepare;
+};
+
+struct Result {
+    double secondsMin;
+    double secondsMedian;
+    double allocations;
+    double bytes;
+    std::size_t output;
+};
+
+const char* pointDistributionName(PointDistribution distribution) {
+    switch (distribution) {
+    case PointDistribution::Uniform:
+        return "uniform";
+    case PointDistribution::Circle:
+        return "circle";
+    case PointDistribution::GaussianClusters:
+        return "clusters";
+    }
+    return "";
+}
+
+const char* segmentDistributionName(SegmentDistribution distribution) {
+    switch (distribution) {
+    case SegmentDistribution::CrossingPairs:
+        return "crossing-pairs";
+    case SegmentDistribution::Short:
+        return "short";
+    case SegmentDistribution::Uniform:
+        return "uniform";
+    case SegmentDistribution::NearCollinear:
+        return "near-collinear";
+    case SegmentDistribution::Vertical:
+        return "vertical";
+    case SegmentDistribution::Grid:
+        return "grid";
+    }
+    return "";
+}
+
+// Distributions whose intersection count grows quadratically are capped,
+// so the suite measures the algorithms rather than the reporting.
+std::size_t maxSegments(SegmentDistribution distribution) {
+    return distribution == SegmentDistribution::Short ||
+                   distribution == SegmentDistribution::Vertical
+               ? ~std::size_t(0)
+               : 4000;
+}
+
+// Runs the benchmark at least repeats times and for at least minTime
+// seconds. Allocations are those of the first run.
+Result measure(const Benchmark& benchmark, int repeats, double minTime) {
+    std::vector<double> times;
+    Result result{};
+    double total = 0.0;
+    while (int(times.size()) < repeats || total < minTime) {
+        const std::size_t count = allocationCount, bytes = allocationBytes;
+        const auto start = std::chrono::steady_clock::now();
+        result.output = benchmark.run();
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (times.empty()) {
+            result.allocations = double(allocationCount - count);
+            result.bytes = double(allocationBytes - bytes);
+        }
+        times.push_back(elapsed.count());
+        total += elapsed.count();
+    }
+    std::sort(times.begin(), times.end());
+    result.secondsMin = times.front();
+    result.secondsMedian = times[times.size() / 2];
+    return result;
+}
+
+} // namespace
+
+// Runs every hull, triangulation, Voronoi, nearest neighbour and intersection
+// routine on every workload distribution for sizes 10^3, 10^4, ... up to
+// --max-size. Prints time, throughput and allocations per operation, and
+// writes the same as JSON to --json so runs on different commits can be
+// compared.
+int main(int argc, char** argv) {
+    Utility::Arguments args;
+    args.addOption("min-size", "1000")
+        .setHelp("min-size", "smallest input size to run")
+        .addOption("max-size", "1000000")
+        .setHelp("max-size", "largest input size to run")
+        .addOption("repeats", "3")
+        .setHelp("repeats", "minimum runs per benchmark")
+        .addOption("min-time", "0.2")
+        .setHelp("min-time", "minimum seconds spent per benchmark")
+        .addOption("threads", "0")
+        .setHelp("threads", "threads for the parallel routines, 0 for all")
+        .addOption("filter", "")
+        .setHelp("filter", "only run benchmarks whose name contains this")
+        .addOption("json", "")
+        .setHelp("json", "file to write the results to as JSON")
+        .addOption("label", "")
+        .setHelp("label", "label stored in the JSON, like a commit hash")
+        .setGlobalHelp(
+            "Hull, triangulation, nearest neighbour and segment intersection "
+            "benchmark suite.")
+        .parse(argc, argv);
+
+    const std::size_t minSize =
+        std::size_t(std::max(1, args.value<int>("min-size")));
+    const std::size_t maxSize =
+        std::size_t(std::max(0, args.value<int>("max-size")));
+    const int repeats = std::max(1, args.value<int>("repeats"));
+    const double minTime = args.value<double>("min-time");
+    const unsigned threads = args.value<unsigned>("threads");
+    const std::string filter = args.value("filter");
+
+    // Inputs are generated once per size and distribution and shared by the
+    // benchmarks using them.
+    std::deque<std::vector<Vector2>> pointSets;
+    std::deque<std::vector<Seg2>> segmentSets;
+    std::deque<std::unique_ptr<KdTree2D>> trees;
+
+    std::vector<Benchmark> benchmarks;
+    const auto add = [&](const std::string& routine,
+                         const std::string& distribution, std::size_t size,
+                         std::function<std::size_t()> run,
+                         std::function<void()> prepare = nullptr) {
+        const std::string name =
+            routine + "/" + distribution + "/" + std::to_string(size);
+        if (name.find(filter) != std::string::npos)
+            benchmarks.push_back({routine, distribution, size, std::move(run),
+                                  std::move(prepare)});
+    };
+
+    for (std::size_t n = minSize; n <= maxSize; n *= 10) {
+        for (PointDistribution distribution :
+             {PointDistribution::Uniform, PointDistribution::Circle,
+              PointDistribution::GaussianClusters}) {
+            pointSets.emplace_back(n);
+            generatePoints(pointSets.back(), distribution);
+            const std::vector<Vector2>* points = &pointSets.back();
+            const char* name = pointDistributionName(distribution);
+            const auto hull = [points](HullAlgorithm algorithm,
+                                       HullPrefilter prefilter) {
+                return [points, algorithm, prefilter]() {
+                    return computeConvexHull2D(*points, algorithm, prefilter)
+                        .size();
+                };
+            };
+            // Gift wrapping every point of a circle is quadratic.
+            if (distribution != PointDistribution::Circle || n <= 10000)
+                add("hull/jarvis", name, n,
+                    hull(HullAlgorithm::JarvisMarch, HullPrefilter::None));
+            add("hull/monotone-chain", name, n,
+                hull(HullAlgorithm::MonotoneChain, HullPrefilter::None));
+            add("hull/chan", name, n,
+                hull(HullAlgorithm::Chan, HullPrefilter::None));
+            add("hull/chan-prefilter", name, n,
+                hull(HullAlgorithm::Chan, HullPrefilter::EightDirections));
+            add("hull/parallel", name, n, [points, threads]() {
+                return compute2DConvexHullParallel(*points, threads).size();
+            });
+            add("delaunay/bowyer-watson", name, n, [points]() {
+                return computeDelaunayTriangulation(*points).size();
+            });
+            add("voronoi/fortune", name, n, [points]() {
+                return computeVoronoiDiagram(*points).edgeCount();
+            });
+
+            // As many queries as points, from the same distribution. The
+            // radius holds about ten uniform points.
+            pointSets.emplace_back(n);
+            generatePoints(pointSets.back(), distribution,
+                           DefaultGeneratorSeed + 1);
+            const std::vector<Vector2>* queries = &pointSets.back();
+            const float radius =
+                1000.0f * std::sqrt(10.0f / (3.14159265f * float(n)));
+            trees.emplace_back();
+            std::unique_ptr<KdTree2D>* tree = &trees.back();
+            const auto build = [points, tree, threads]() {
+                if (!*tree)
+                    tree->reset(new KdTree2D{*points, threads});
+            };
+            add("density/pyramid", name, n, [points, threads]() {
+                return std::size_t(
+                    DensityPyramid{*points, 1024, threads}.maxCount(0));
+            });
+            add("kd-tree/build", name, n, [points, threads]() {
+                return KdTree2D{*points, threads}.size();
+            });
+            add("knn/kd-tree", name, n,
+                [queries, tree, threads]() {
+                    return findNearestNeighbours(**tree, *queries, 8, threads)
+                        .size();
+                },
+                build);
+            if (n <= 10000)
+                add("knn/brute-force", name, n, [points, queries]() {
+                    return findNearestNeighboursBruteForce(*points, *queries, 8)
+                        .size();
+                });
+            add("radius/kd-tree", name, n,
+                [queries, tree, radius, threads]() {
+                    return findPointsWithinRadius(**tree, *queries, radius,
+                                                  threads)
+                        .indices.size();
+                },
+                build);
+        }
+
+        for (SegmentDistribution distribution :
+             {SegmentDistribution::CrossingPairs, SegmentDistribution::Short,
+              SegmentDistribution::Uniform, SegmentDistribution::NearCollinear,
+              SegmentDistribution::Vertical, SegmentDistribution::Grid}) {
+            if (n > maxSegments(distribution))
+                continue;
+            segmentSets.emplace_back(n, Seg2(Vector2{}, Vector2{}));
+            generateSegments(segmentSets.back(), distribution);
+            const std::vector<Seg2>* segs = &segmentSets.back();
+            const char* name = segmentDistributionName(distribution);
+            add("intersection/sweep", name, n,
+                [segs]() { return countSegmentIntersections(*segs); });
+            add("intersection/sweep-parallel", name, n, [segs, threads]() {
+                return findAllSegmentIntersectionsParallel(*segs, threads)
+                    .size();
+            });
+            add("intersection/grid", name, n, [segs, threads]() {
+                return findSegmentIntersectionsGrid(*segs, threads).size();
+            });
+            if (n <= 10000)
+                add("intersection/brute-force", name, n, [segs]() {
+                    return findSegmentIntersectionsBruteForce(*segs).size();
+                });
+            // The pair kernels on consecutive pairs.
+            add("seg2/intersect", name, n, [segs]() {
+                std::size_t hits = 0;
+                for (std::size_t i = 0; i + 1 < segs->size(); ++i)
+                    hits += bool((*segs)[i].intersect((*segs)[i + 1]));
+                return hits;
+            });
+            add("seg2/intersect-batch", name, n, [segs]() {
+                SegmentPairBatch batch;
+                batch.reserve(segs->size());
+                for (std::size_t i = 0; i + 1 < segs->size(); ++i)
+                    batch.add((*segs)[i], (*segs)[i + 1]);
+                std::vector<std::size_t> hitPairs;
+                std::vector<Seg2Intersection> hits;
+                return intersectBatch(batch, hitPairs, hits);
+            });
+        }
+    }
+
+    std::printf("%-30s %-15s %9s %12s %14s %12s %12s\n", "routine",
+                "distribution", "size", "seconds", "items/s", "allocs/op",
+                "output");
+    std::string json = "{\n  \"label\": " + jsonString(args.value("label")) +
+                       ",\n  \"threads\": " +
+                       std::to_string(resolveThreadCount(threads)) +
+                       ",\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < benchmarks.size(); ++i) {
+        const Benchmark& b = benchmarks[i];
+        if (b.prepare)
+            b.prepare();
+        const Result r = measure(b, repeats, minTime);
+        const double throughput = double(b.size) / r.secondsMin;
+        std::printf("%-30s %-15s %9zu %12.6f %14.4g %12.0f %12zu\n",
+                    b.routine.c_str(), b.distribution.c_str(), b.size,
+                    r.secondsMin, throughput, r.allocations, r.output);
+        std::fflush(stdout);
+
+        json += i == 0 ? "\n    " : ",\n    ";
+        json += JsonObject{}
+                    .addString("name", b.routine + "/" + b.distribution +
+                                           "/" + std::to_string(b.size))
+                    .addString("routine", b.routine)
+                    .addString("distribution", b.distribution)
+                    .addInteger("size", b.size)
+                    .addNumber("seconds_min", r.secondsMin)
+                    .addNumber("seconds_median", r.secondsMedian)
+                    .addNumber("items_per_second", throughput)
+                    .addInteger("allocations_per_op",
+                                (unsigned long long)(r.allocations))
+                    .addInteger("bytes_allocated_per_op",
+                                (unsigned long long)(r.bytes))
+                    .addInteger("output", r.output)
+                    .str();
+    }
+    json += "\n  ]\n}\n";
+
+    const std::string path = args.value("json");
+    if (!path.empty() && !writeJson(path, json))
+        return 1;
+
+    return 0;
+}
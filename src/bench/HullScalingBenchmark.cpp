@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <Corrade/Utility/Arguments.h>
+
+#include "core/CompGeomCore.h"
+
+using namespace Magnum;
+using namespace CompGeom;
+
+// Times compute2DConvexHullParallel() on the same random point cloud for 1,
+// 2, 4, ... up to --max-threads threads and prints the speedup over the
+// single threaded run.
+int main(int argc, char** argv) {
+    Utility::Arguments args;
+    args.addOption("points", "10000000")
+        .setHelp("points", "number of random points")
+        .addOption("max-threads", "64")
+        .setHelp("max-threads", "largest thread count to run")
+        .addOption("repeats", "3")
+        .setHelp("repeats", "runs per thread count, the fastest is reported")
+        .setGlobalHelp("Parallel convex hull scaling benchmark.")
+        .parse(argc, argv);
+
+    const int number = args.value<int>("points");
+    const unsigned maxThreads = args.value<unsigned>("max-threads");
+    const int repeats = std::max(1, args.value<int>("repeats"));
+
+    std::vector<Vector2> points(std::size_t(std::max(number, 0)));
+    generatePoints(points, PointDistribution::Uniform);
+
+    std::printf("%10s %12s %10s %10s\n", "threads", "seconds", "speedup",
+                "hull");
+    double baseline = 0.0;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        double best = 0.0;
+        std::size_t hullSize = 0;
+        for (int r = 0; r < repeats; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            const std::vector<Vector2> hull =
+                compute2DConvexHullParallel(points, threads);
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+            if (r == 0 || elapsed.count() < best)
+                best = elapsed.count();
+            hullSize = hull.size();
+        }
+        if (threads == 1)
+            baseline = best;
+        std::printf("%10u %12.4f %10.2f %10zu\n", threads, best,
+                    baseline / best, hullSize);
+    }
+
+    return 0;
+}
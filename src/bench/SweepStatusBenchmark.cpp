@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <Corrade/Utility/Arguments.h>
+
+#include "core/CompGeomCore.h"
+
+using namespace Magnum;
+using namespace CompGeom;
+
+namespace {
+
+// Fastest of repeats runs in seconds, the intersection count goes to count.
+double timeSweep(const std::vector<Seg2>& segs, SweepStatus status,
+                 int repeats, std::size_t& count) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        count = 0;
+        const auto start = std::chrono::steady_clock::now();
+        sweepSegmentIntersections(
+            segs,
+            [&](int, int, const Vector2&) {
+                ++count;
+                return true;
+            },
+            status);
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (r == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+} // namespace
+
+// Times the Bentley-Ottmann sweep with each status structure for 10^4,
+// 10^5, ... up to --max-segments segments.
+int main(int argc, char** argv) {
+    Utility::Arguments args;
+    args.addOption("min-segments", "10000")
+        .setHelp("min-segments", "smallest segment count to run")
+        .addOption("max-segments", "10000000")
+        .setHelp("max-segments", "largest segment count to run")
+        .addOption("repeats", "1")
+        .setHelp("repeats", "runs per structure, the fastest is reported")
+        .setGlobalHelp("Sweep line status structure benchmark.")
+        .parse(argc, argv);
+
+    const int minSegments = std::max(1, args.value<int>("min-segments"));
+    const int maxSegments = args.value<int>("max-segments");
+    const int repeats = std::max(1, args.value<int>("repeats"));
+
+    std::printf("%10s %12s %12s %12s %12s\n", "segments", "intersections",
+                "set", "arena set", "skip list");
+    for (long long number = minSegments; number <= maxSegments;
+         number *= 10) {
+        // Short segments, so the number of intersections grows linearly
+        // and the sweep cost is dominated by the status line rather than
+        // by reporting.
+        std::vector<Seg2> segs(std::size_t(number), Seg2(Vector2{}, Vector2{}));
+        generateSegments(segs, SegmentDistribution::Short,
+                         DefaultGeneratorSeed + std::uint64_t(number));
+        std::size_t count = 0;
+        const double set =
+            timeSweep(segs, SweepStatus::Set, repeats, count);
+        const double arena =
+            timeSweep(segs, SweepStatus::ArenaSet, repeats, count);
+        const double skipList =
+            timeSweep(segs, SweepStatus::SkipList, repeats, count);
+        std::printf("%10lld %12zu %12.4f %12.4f %12.4f\n", number, count, set,
+                    arena, skipList);
+    }
+
+    return 0;
+}
@@ -0,0 +1,398 @@
+#include "core/BentleyOttmann.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "core/Predicates.h"
+#include "core/SegmentTable.h"
+#include "core/SweepStatus.h"
+
+namespace CompGeom {
+
+namespace {
+
+// Event points by x then y, exact, so every copy of a crossing of three or
+// more segments lands on the same event.
+struct LexLess {
+    bool operator()(const ExactPoint& lhs, const ExactPoint& rhs) const {
+        const int x = compareX(lhs, rhs);
+        return x < 0 || (x == 0 && compareY(lhs, rhs) < 0);
+    }
+};
+
+// Two layer mode: segments before firstBlue are red, the rest blue, and
+// only red-blue pairs are reported. Unless a layer can cross itself the
+// crossings within a layer aren't even looked for. A negative firstBlue
+// means a single layer.
+struct SweepLayers {
+    int firstBlue;
+    bool selfIntersect;
+};
+
+// Segments starting, ending and known to cross at an event point.
+struct EventLists {
+    std::vector<int> upper;
+    std::vector<int> lower;
+    std::vector<int> crossing;
+};
+
+// Segment geometry and the status line order at the current event point,
+// shared by all status structures.
+class SweepOrder {
+  public:
+    explicit SweepOrder(Containers::ArrayView<const Seg2> segs)
+        : segs_(segs), atEvent_(segs.size(), 0) {}
+
+    // Status order at the sweep point. The probe index stands for the event
+    // point itself, sorting before segments passing through it.
+    bool less(int a, int b) const {
+        const int height = compareHeights(a, b);
+        if (height != 0)
+            return height < 0;
+        const int slope = compareSlopes(a, b);
+        if (slope != 0)
+            return reverseSlopes_ ? slope > 0 : slope < 0;
+        return a < b;
+    }
+
+    static constexpr int ProbeIndex = -1;
+
+  protected:
+    // Sign of the slope of a minus the slope of b, exact. Vertical segments
+    // are steepest and the probe is below every slope.
+    int compareSlopes(int a, int b) const {
+        if (a == b)
+            return 0;
+        if (a == ProbeIndex || b == ProbeIndex)
+            return a == ProbeIndex ? -1 : 1;
+        return segs_.compareSlopes(a, b);
+    }
+
+    // Whether s passes through the sweep point, exact. Segments flagged as
+    // at the event are known to.
+    bool contains(int s) const {
+        if (atEvent_[s])
+            return true;
+        const Vector2d l = segs_.left(s), r = segs_.right(s);
+        const ExactPoint& p = sweepPoint_;
+        if (compareX(p, l.x()) < 0 || compareX(p, r.x()) > 0)
+            return false;
+        if (segs_.isVertical(s))
+            return compareY(p, l.y()) >= 0 && compareY(p, r.y()) <= 0;
+        return segs_.compareHeight(s, p) == 0;
+    }
+
+    // Height of a segment on the sweep line: exactly at the sweep point for
+    // segments flagged as passing through it, a known value for vertical
+    // ones, clamped to it, and ones not spanning the sweep x, at their
+    // endpoint, or on the line of the segment otherwise.
+    struct Height {
+        enum Kind { AtSweep, AtValue, OnLine } kind;
+        double y;
+    };
+
+    Height height(int s) const {
+        const ExactPoint& p = sweepPoint_;
+        if (s == ProbeIndex || atEvent_[s])
+            return {Height::AtSweep, 0.0};
+        const Vector2d l = segs_.left(s), r = segs_.right(s);
+        if (segs_.isVertical(s)) {
+            if (compareY(p, l.y()) < 0)
+                return {Height::AtValue, l.y()};
+            if (compareY(p, r.y()) > 0)
+                return {Height::AtValue, r.y()};
+            return {Height::AtSweep, 0.0};
+        }
+        if (compareX(p, l.x()) <= 0)
+            return {Height::AtValue, l.y()};
+        if (compareX(p, r.x()) >= 0)
+            return {Height::AtValue, r.y()};
+        return {Height::OnLine, 0.0};
+    }
+
+    // Sign of the height of non-vertical s spanning the sweep x minus the
+    // height h, exact.
+    int compareHeight(int s, const Height& h) const {
+        return h.kind == Height::AtSweep
+                   ? segs_.compareHeight(s, sweepPoint_)
+                   : segs_.compareHeight(s, sweepPoint_, h.y);
+    }
+
+    // Sign of the height of a minus the height of b on the sweep line,
+    // exact.
+    int compareHeights(int a, int b) const {
+        const Height ha = height(a), hb = height(b);
+        if (ha.kind == Height::OnLine && hb.kind == Height::OnLine)
+            return segs_.compareHeights(a, b, sweepPoint_);
+        if (ha.kind == Height::OnLine)
+            return compareHeight(a, hb);
+        if (hb.kind == Height::OnLine)
+            return -compareHeight(b, ha);
+        if (ha.kind == Height::AtSweep && hb.kind == Height::AtSweep)
+            return 0;
+        if (ha.kind == Height::AtSweep)
+            return compareY(sweepPoint_, hb.y);
+        if (hb.kind == Height::AtSweep)
+            return -compareY(sweepPoint_, ha.y);
+        return int(ha.y > hb.y) - int(ha.y < hb.y);
+    }
+
+    SegmentTable segs_;
+    std::vector<char> atEvent_;
+    ExactPoint sweepPoint_;
+    // Orders segments meeting at the sweep point as just before it instead
+    // of just after.
+    bool reverseSlopes_ = false;
+};
+
+// Orders the status line just after the current event point.
+struct StatusLess {
+    const SweepOrder* order;
+    bool operator()(int a, int b) const { return order->less(a, b); }
+};
+
+template <class Status> class Sweep : public SweepOrder {
+  public:
+    Sweep(Containers::ArrayView<const Seg2> segs, const SweepSlab& slab,
+          const SweepLayers& layers)
+        : SweepOrder(segs), status_(segs.size(), StatusLess{this}),
+          slab_(slab), layers_(layers) {}
+
+    void run(const IntersectionCallback& report) {
+        std::vector<int> crossingBegin;
+        for (int i = 0; i < int(segs_.size()); ++i) {
+            const double left = segs_.left(i).x();
+            const double right = segs_.right(i).x();
+            if (right < slab_.begin || left > slab_.end ||
+                (left == slab_.end && !slab_.closed))
+                continue;
+            if (left < slab_.begin)
+                crossingBegin.push_back(i);
+            else
+                queue_[ExactPoint{segs_.left(i)}].upper.push_back(i);
+            queue_[ExactPoint{segs_.right(i)}].lower.push_back(i);
+        }
+        if (!crossingBegin.empty())
+            startAtSlab(crossingBegin);
+
+        std::vector<int> passing, involved, removed, inserted;
+        while (!queue_.empty()) {
+            const ExactPoint p = queue_.begin()->first;
+            const int end = compareX(p, slab_.end);
+            if (end > 0 || (end == 0 && !slab_.closed))
+                break;
+            EventLists event = std::move(queue_.begin()->second);
+            queue_.erase(queue_.begin());
+            sweepPoint_ = p;
+
+            // Segments on the status line through p, contiguous just above
+            // the probe. This picks up endpoints touching the interior of a
+            // segment. The ones known to meet at p are flagged meanwhile,
+            // which saves proving it again.
+            passing.clear();
+            for (int s : event.crossing)
+                atEvent_[s] = 1;
+            for (int s : event.lower)
+                atEvent_[s] = 1;
+            const int probe = ProbeIndex;
+            for (int s = status_.lowerBound(probe);
+                 s != StatusEnd && contains(s); s = status_.next(s))
+                passing.push_back(s);
+            for (int s : event.crossing)
+                atEvent_[s] = 0;
+            for (int s : event.lower)
+                atEvent_[s] = 0;
+
+            // Report every pair meeting at this point.
+            involved.assign(event.upper.begin(), event.upper.end());
+            involved.insert(involved.end(), event.lower.begin(),
+                            event.lower.end());
+            involved.insert(involved.end(), event.crossing.begin(),
+                            event.crossing.end());
+            involved.insert(involved.end(), passing.begin(), passing.end());
+            std::sort(involved.begin(), involved.end());
+            involved.erase(std::unique(involved.begin(), involved.end()),
+                           involved.end());
+            const Vector2 point{p.approximate()};
+            for (std::size_t i = 0; i < involved.size(); ++i) {
+                for (std::size_t j = i + 1; j < involved.size(); ++j) {
+                    const int a = involved[i], b = involved[j];
+                    if (sameLayer(a, b))
+                        continue;
+                    // Collinear overlapping segments meet at several event
+                    // points, only report them at the first one.
+                    if (compareSlopes(a, b) == 0 &&
+                        !isFirstSharedPoint(a, b, p))
+                        continue;
+                    if (!report(a, b, point))
+                        return;
+                }
+            }
+
+            // Segments ending or crossing here leave the status line, the
+            // crossing ones come back reordered together with the starting
+            // ones.
+            removed.assign(event.lower.begin(), event.lower.end());
+            removed.insert(removed.end(), event.crossing.begin(),
+                           event.crossing.end());
+            removed.insert(removed.end(), passing.begin(), passing.end());
+            for (int s : removed) {
+                if (status_.contains(s))
+                    status_.erase(s);
+            }
+            inserted.clear();
+            const std::vector<int>* lists[]{&event.upper, &event.crossing,
+                                            &passing};
+            for (const std::vector<int>* list : lists) {
+                for (int s : *list) {
+                    if (!status_.contains(s) &&
+                        std::find(event.lower.begin(), event.lower.end(), s) ==
+                            event.lower.end() &&
+                        std::find(inserted.begin(), inserted.end(), s) ==
+                            inserted.end())
+                        inserted.push_back(s);
+                }
+            }
+
+            if (inserted.empty()) {
+                // Only removals, the segments around the gap become
+                // neighbours.
+                const int upper = status_.lowerBound(probe);
+                const int lower = status_.prev(upper);
+                if (upper != StatusEnd && lower != StatusEnd)
+                    findEvent(lower, upper);
+                continue;
+            }
+
+            // All inserted segments pass through p, flagging them makes the
+            // comparator order them by slope, i.e. just after p.
+            for (int s : inserted)
+                atEvent_[s] = 1;
+            int lowest = inserted.front(), highest = inserted.front();
+            for (int s : inserted) {
+                status_.insert(s);
+                if (less(s, lowest))
+                    lowest = s;
+                if (less(highest, s))
+                    highest = s;
+            }
+            for (int s : inserted)
+                atEvent_[s] = 0;
+
+            const int below = status_.prev(lowest);
+            if (below != StatusEnd)
+                findEvent(below, lowest);
+            const int above = status_.next(highest);
+            if (above != StatusEnd)
+                findEvent(highest, above);
+        }
+    }
+
+  private:
+    // Whether p is the lexicographically first point shared by collinear a
+    // and b, the larger of their left endpoints.
+    bool isFirstSharedPoint(int a, int b, const ExactPoint& p) const {
+        const Vector2d la = segs_.left(a), lb = segs_.left(b);
+        const Vector2d first =
+            la.x() < lb.x() || (la.x() == lb.x() && la.y() < lb.y()) ? lb
+                                                                     : la;
+        return compareX(p, first.x()) == 0 && compareY(p, first.y()) == 0;
+    }
+
+    bool sameLayer(int a, int b) const {
+        return layers_.firstBlue >= 0 &&
+               (a < layers_.firstBlue) == (b < layers_.firstBlue);
+    }
+
+    // Puts the segments crossing the start of the slab on the status line in
+    // their order just before it, as if everything left of it had been
+    // swept, and queues the crossings of neighbours.
+    void startAtSlab(std::vector<int>& segments) {
+        sweepPoint_ = ExactPoint{
+            Vector2d{slab_.begin, std::numeric_limits<double>::lowest()}};
+        reverseSlopes_ = true;
+        std::sort(segments.begin(), segments.end(),
+                  [this](int a, int b) { return less(a, b); });
+        for (int s : segments)
+            status_.insert(s);
+        reverseSlopes_ = false;
+        for (std::size_t i = 0; i + 1 < segments.size(); ++i)
+            findEvent(segments[i], segments[i + 1]);
+    }
+
+    // Queues the crossing of neighbours below and above if it is ahead of
+    // the sweep point. Neighbours can only cross ahead if the lower one is
+    // steeper, which also keeps pairs that just swapped from being found
+    // again. The crossing is kept exact, so all pairs crossing at one point
+    // queue the same event.
+    void findEvent(int below, int above) {
+        if (!layers_.selfIntersect && sameLayer(below, above))
+            return;
+        if (compareSlopes(below, above) <= 0 || !segs_.intersects(below, above))
+            return;
+        const ExactPoint q{segs_.left(below), segs_.right(below),
+                           segs_.left(above), segs_.right(above)};
+        if (!LexLess{}(sweepPoint_, q))
+            return;
+        EventLists& event = queue_[q];
+        event.crossing.push_back(below);
+        event.crossing.push_back(above);
+    }
+
+    std::map<ExactPoint, EventLists, LexLess> queue_;
+    Status status_;
+    SweepSlab slab_;
+    SweepLayers layers_;
+};
+
+template <class Status>
+void runSweep(Containers::ArrayView<const Seg2> segs,
+              const IntersectionCallback& report, const SweepSlab& slab,
+              const SweepLayers& layers) {
+    Sweep<Status> sweep{segs, slab, layers};
+    sweep.run(report);
+}
+
+void sweep(Containers::ArrayView<const Seg2> segs,
+           const IntersectionCallback& report, SweepStatus status,
+           const SweepSlab& slab, const SweepLayers& layers) {
+    switch (status) {
+    case SweepStatus::Set:
+        return runSweep<SetStatus<StatusLess>>(segs, report, slab, layers);
+    case SweepStatus::ArenaSet:
+        return runSweep<ArenaSetStatus<StatusLess>>(segs, report, slab,
+                                                    layers);
+    case SweepStatus::SkipList:
+        return runSweep<SkipListStatus<StatusLess>>(segs, report, slab,
+                                                    layers);
+    }
+}
+
+} // namespace
+
+void sweepSegmentIntersections(Containers::ArrayView<const Seg2> segs,
+                               const IntersectionCallback& report,
+                               SweepStatus status, const SweepSlab& slab) {
+    sweep(segs, report, status, slab, SweepLayers{-1, true});
+}
+
+void sweepRedBlueIntersections(Containers::ArrayView<const Seg2> red,
+                               Containers::ArrayView<const Seg2> blue,
+                               const RedBlueCallback& report,
+                               bool layersSelfIntersect, SweepStatus status) {
+    // One sweep over both layers, red first so a reported a < b is always
+    // red, blue.
+    std::vector<Seg2> segs;
+    segs.reserve(red.size() + blue.size());
+    segs.insert(segs.end(), red.begin(), red.end());
+    segs.insert(segs.end(), blue.begin(), blue.end());
+    const int firstBlue = int(red.size());
+    sweep(segs,
+          [&](int a, int b, const Vector2& point) {
+              return report(a, b - firstBlue, point);
+          },
+          status, SweepSlab{}, SweepLayers{firstBlue, layersSelfIntersect});
+}
+
+} // namespace CompGeom
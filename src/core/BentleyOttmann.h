@@ -0,0 +1,71 @@
+#ifndef COMP_GEOM_CORE_BENTLEYOTTMANN_H
+#define COMP_GEOM_CORE_BENTLEYOTTMANN_H
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Seg2.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Called once for every intersecting pair of segments, with a < b indexing
+// the input. Returning false stops the sweep.
+typedef std::function<bool(int a, int b, const Vector2& point)>
+    IntersectionCallback;
+
+// Called once for every intersecting pair of a red and a blue segment,
+// indexing the two inputs. Returning false stops the sweep.
+typedef std::function<bool(int red, int blue, const Vector2& point)>
+    RedBlueCallback;
+
+// Data structure holding the segments crossing the sweep line, see
+// core/SweepStatus.h.
+enum class SweepStatus {
+    Set,      // std::set, a heap allocated node per insertion.
+    ArenaSet, // std::set with nodes recycled from an arena.
+    SkipList  // Index based skip list, no allocation while sweeping.
+};
+
+// Vertical slab begin <= x < end, or x <= end when closed, a sweep can be
+// restricted to. The sweep then starts with the segments crossing x = begin
+// already on the status line instead of sweeping everything left of it,
+// stops at end, and only reports intersections inside the slab.
+struct SweepSlab {
+    double begin = -std::numeric_limits<double>::infinity();
+    double end = std::numeric_limits<double>::infinity();
+    bool closed = true;
+};
+
+// Bentley-Ottmann sweep, reports every intersecting pair exactly once in
+// O((n + k) log n). Event points are ordered by x then y, so vertical
+// segments are handled too. The order is exact, crossings included, so any
+// number of segments through one point meet at a single event. Segments
+// touching at an endpoint count as intersecting, collinear overlapping
+// segments are reported at the first point they share.
+void sweepSegmentIntersections(Containers::ArrayView<const Seg2> segs,
+                               const IntersectionCallback& report,
+                               SweepStatus status = SweepStatus::ArenaSet,
+                               const SweepSlab& slab = SweepSlab{});
+
+// Red-blue (bichromatic) Bentley-Ottmann sweep over two layers at once,
+// reporting only pairs with one segment from each, with the same semantics
+// otherwise. Crossings within a layer still have to be swept over unless
+// layersSelfIntersect is false, which promises that no two segments of the
+// same layer cross (touching and overlapping is fine) and lets the sweep
+// skip them entirely. A broken promise loses red-blue intersections.
+void sweepRedBlueIntersections(Containers::ArrayView<const Seg2> red,
+                               Containers::ArrayView<const Seg2> blue,
+                               const RedBlueCallback& report,
+                               bool layersSelfIntersect = true,
+                               SweepStatus status = SweepStatus::ArenaSet);
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef COMP_GEOM_CORE_COMPGEOMCORE_H
+#define COMP_GEOM_CORE_COMPGEOMCORE_H
+
+// Public header of the comp_geom_core library. Only depends on Magnum's math
+// types, so it can be used without a GL context or a window.
+
+#include "core/BentleyOttmann.h"
+#include "core/Delaunay.h"
+#include "core/DensityPyramid.h"
+#include "core/Generators.h"
+#include "core/GeometryFile.h"
+#include "core/Hull.h"
+#include "core/HullPrefilter.h"
+#include "core/Intersection.h"
+#include "core/KdTree.h"
+#include "core/Parallel.h"
+#include "core/Predicates.h"
+#include "core/Seg2.h"
+#include "core/SegmentBatch.h"
+#include "core/SegmentGrid.h"
+#include "core/SegmentTable.h"
+#include "core/SweepStatus.h"
+#include "core/Types.h"
+#include "core/Voronoi.h"
+
+#endif
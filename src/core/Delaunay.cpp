@@ -0,0 +1,314 @@
+#include "core/Delaunay.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <Magnum/Math/Functions.h>
+
+#include "core/Predicates.h"
+
+namespace CompGeom {
+
+namespace {
+
+// Vertex at infinity. Each hull edge gets a ghost triangle with it, so every
+// real triangle has three neighbours and points outside the hull are
+// inserted the same way as points inside.
+constexpr std::uint32_t Ghost = 0xffffffffu;
+
+// Side of the Hilbert curve grid used for the insertion order.
+constexpr std::uint32_t HilbertSide = 1u << 14;
+
+// SplitMix64 finalizer, deciding the BRIO round of each point.
+std::uint64_t mix(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+std::uint32_t hilbertIndex(std::uint32_t x, std::uint32_t y) {
+    std::uint32_t d = 0;
+    for (std::uint32_t s = HilbertSide / 2; s > 0; s /= 2) {
+        const std::uint32_t rx = (x & s) > 0, ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = HilbertSide - 1 - x;
+                y = HilbertSide - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+// Whether c, collinear with a and b, lies strictly between them.
+bool strictlyBetween(const Vector2& a, const Vector2& b, const Vector2& c) {
+    if (a.x() != b.x())
+        return std::min(a.x(), b.x()) < c.x() && c.x() < std::max(a.x(), b.x());
+    return std::min(a.y(), b.y()) < c.y() && c.y() < std::max(a.y(), b.y());
+}
+
+int next(int i) { return i == 2 ? 0 : i + 1; }
+int prev(int i) { return i == 0 ? 2 : i - 1; }
+
+class Triangulator {
+  public:
+    explicit Triangulator(Containers::ArrayView<const Vector2> points)
+        : points_(points), startOf_(points.size() + 1) {}
+
+    // Starts with the counterclockwise triangle a, b, c and its three ghosts.
+    void init(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+        vertices_ = {a, b, c, b, a, Ghost, c, b, Ghost, a, c, Ghost};
+        neighbours_ = {2, 3, 1, 3, 2, 0, 1, 3, 0, 2, 1, 0};
+        marks_.assign(4, 0);
+        last_ = 0;
+    }
+
+    void insert(std::uint32_t index) {
+        const Vector2& p = points_[index];
+        const std::uint32_t start = locate(p);
+        if (!isGhost(start)) {
+            for (int i = 0; i != 3; ++i) {
+                if (points_[vertices_[3 * start + i]] == p)
+                    return;
+            }
+        }
+
+        // Grow the cavity of triangles whose circumcircle holds p from the
+        // one containing it, collecting the edges around it.
+        ++stamp_;
+        conflicts_.clear();
+        boundary_.clear();
+        stack_.assign(1, start);
+        marks_[start] = stamp_;
+        while (!stack_.empty()) {
+            const std::uint32_t t = stack_.back();
+            stack_.pop_back();
+            conflicts_.push_back(t);
+            for (int i = 0; i != 3; ++i) {
+                const std::uint32_t other = neighbours_[3 * t + i];
+                if (marks_[other] == stamp_)
+                    continue;
+                if (inConflict(other, p)) {
+                    marks_[other] = stamp_;
+                    stack_.push_back(other);
+                    continue;
+                }
+                int back = 0;
+                while (neighbours_[3 * other + back] != t)
+                    ++back;
+                boundary_.push_back({vertices_[3 * t + next(i)],
+                                     vertices_[3 * t + prev(i)], other,
+                                     std::uint32_t(back)});
+            }
+        }
+
+        // Connect p to every boundary edge, reusing the cavity's slots. The
+        // cavity is star shaped from p, so each boundary vertex starts
+        // exactly one edge.
+        created_.clear();
+        for (std::size_t i = 0; i != boundary_.size(); ++i) {
+            const Edge& e = boundary_[i];
+            std::uint32_t t;
+            if (i < conflicts_.size()) {
+                t = conflicts_[i];
+            } else {
+                t = std::uint32_t(marks_.size());
+                vertices_.resize(vertices_.size() + 3);
+                neighbours_.resize(neighbours_.size() + 3);
+                marks_.push_back(0);
+            }
+            created_.push_back(t);
+            vertices_[3 * t + 0] = e.from;
+            vertices_[3 * t + 1] = e.to;
+            vertices_[3 * t + 2] = index;
+            neighbours_[3 * t + 2] = e.outside;
+            neighbours_[3 * e.outside + e.back] = t;
+            startOf_[slot(e.from)] = t;
+        }
+        for (const std::uint32_t t : created_) {
+            const std::uint32_t after = startOf_[slot(vertices_[3 * t + 1])];
+            neighbours_[3 * t + 0] = after;
+            neighbours_[3 * after + 1] = t;
+        }
+        last_ = created_.back();
+    }
+
+    // Real triangles renumbered without the ghosts.
+    DelaunayTriangulation finish() const {
+        const std::size_t count = marks_.size();
+        std::vector<std::uint32_t> renumbered(count, DelaunayNoNeighbour);
+        std::uint32_t real = 0;
+        for (std::size_t t = 0; t != count; ++t) {
+            if (!isGhost(std::uint32_t(t)))
+                renumbered[t] = real++;
+        }
+        DelaunayTriangulation out;
+        out.triangles.reserve(3 * std::size_t(real));
+        out.neighbours.reserve(3 * std::size_t(real));
+        for (std::size_t t = 0; t != count; ++t) {
+            if (renumbered[t] == DelaunayNoNeighbour)
+                continue;
+            for (int i = 0; i != 3; ++i) {
+                out.triangles.push_back(vertices_[3 * t + i]);
+                out.neighbours.push_back(renumbered[neighbours_[3 * t + i]]);
+            }
+        }
+        return out;
+    }
+
+  private:
+    // Edge from -> to of the cavity boundary, seen from inside, with the
+    // triangle outside it and the index of the cavity in its neighbours.
+    struct Edge {
+        std::uint32_t from, to, outside, back;
+    };
+
+    bool isGhost(std::uint32_t t) const {
+        return vertices_[3 * t + 2] == Ghost || vertices_[3 * t + 1] == Ghost ||
+               vertices_[3 * t + 0] == Ghost;
+    }
+
+    std::size_t slot(std::uint32_t vertex) const {
+        return vertex == Ghost ? points_.size() : vertex;
+    }
+
+    // Whether p is strictly inside the circumcircle of triangle t. For a
+    // ghost triangle the circle is the open half plane beyond its hull edge
+    // plus the open edge itself.
+    bool inConflict(std::uint32_t t, const Vector2& p) const {
+        const std::uint32_t* v = &vertices_[3 * t];
+        for (int i = 0; i != 3; ++i) {
+            if (v[i] != Ghost)
+                continue;
+            const Vector2& a = points_[v[next(i)]];
+            const Vector2& b = points_[v[prev(i)]];
+            const double side = orient2d(a, b, p);
+            return side > 0.0 || (side == 0.0 && strictlyBetween(a, b, p));
+        }
+        return incircle(points_[v[0]], points_[v[1]], points_[v[2]], p) > 0.0;
+    }
+
+    // Walks from the last inserted triangle to one containing p, or to a
+    // ghost triangle whose hull edge sees p if p is outside the hull.
+    std::uint32_t locate(const Vector2& p) {
+        std::uint32_t t = last_;
+        for (;;) {
+            const std::uint32_t* v = &vertices_[3 * t];
+            int ghost = -1;
+            for (int i = 0; i != 3; ++i) {
+                if (v[i] == Ghost)
+                    ghost = i;
+            }
+            if (ghost != -1) {
+                if (inConflict(t, p))
+                    return t;
+                t = neighbours_[3 * t + ghost];
+                continue;
+            }
+            // Trying the edges from a varying first one keeps the walk from
+            // cycling on degenerate inputs.
+            int i = int(++walks_ % 3), tried = 0;
+            while (tried != 3 && orient2d(points_[v[next(i)]],
+                                          points_[v[prev(i)]], p) >= 0.0) {
+                i = next(i);
+                ++tried;
+            }
+            if (tried == 3)
+                return t;
+            t = neighbours_[3 * t + i];
+        }
+    }
+
+    Containers::ArrayView<const Vector2> points_;
+    std::vector<std::uint32_t> vertices_;
+    std::vector<std::uint32_t> neighbours_;
+    // Stamp of the insertion that last put each triangle in its cavity.
+    std::vector<std::uint32_t> marks_;
+    // New triangle starting at each vertex, the ghost at the end.
+    std::vector<std::uint32_t> startOf_;
+    std::vector<std::uint32_t> conflicts_, created_, stack_;
+    std::vector<Edge> boundary_;
+    std::uint32_t stamp_ = 0;
+    std::uint32_t last_ = 0;
+    std::uint32_t walks_ = 0;
+};
+
+} // namespace
+
+std::vector<std::uint32_t>
+computeBrioOrder(Containers::ArrayView<const Vector2> points) {
+    const std::size_t n = points.size();
+    if (n == 0)
+        return {};
+
+    Vector2 min = points[0], max = points[0];
+    for (const Vector2& p : points) {
+        min = Math::min(min, p);
+        max = Math::max(max, p);
+    }
+    const Vector2 scale =
+        Vector2{float(HilbertSide - 1)} / Math::max(max - min, Vector2{1e-30f});
+
+    // Each point falls in the last round with probability 1/2, the one
+    // before with 1/4 and so on, the first round taking what's left of
+    // about 64 points.
+    int rounds = 1;
+    while (rounds < 32 && (n >> (rounds + 6)) > 0)
+        ++rounds;
+
+    // Round, then Hilbert index, then point index, packed for one sort.
+    std::vector<std::uint64_t> keys(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        const Vector2 cell = (points[i] - min) * scale;
+        const std::uint32_t h = hilbertIndex(std::uint32_t(cell.x()),
+                                             std::uint32_t(cell.y()));
+        std::uint64_t bits = mix(i + 0x9e3779b97f4a7c15ull);
+        int fromEnd = 0;
+        while (fromEnd < rounds - 1 && !(bits & 1)) {
+            bits >>= 1;
+            ++fromEnd;
+        }
+        const std::uint64_t round = std::uint64_t(rounds - 1 - fromEnd);
+        keys[i] = round << 59 | std::uint64_t(h) << 31 | i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<std::uint32_t> order(n);
+    for (std::size_t i = 0; i != n; ++i)
+        order[i] = std::uint32_t(keys[i] & 0x7fffffffu);
+    return order;
+}
+
+DelaunayTriangulation
+computeDelaunayTriangulation(Containers::ArrayView<const Vector2> points) {
+    std::vector<std::uint32_t> order = computeBrioOrder(points);
+
+    // The first triangle is the first three affinely independent points in
+    // order, moved to the front.
+    std::size_t second = 1;
+    while (second < order.size() &&
+           points[order[second]] == points[order[0]])
+        ++second;
+    std::size_t third = second + 1;
+    while (third < order.size() &&
+           orient2d(points[order[0]], points[order[second]],
+                    points[order[third]]) == 0.0)
+        ++third;
+    if (third >= order.size())
+        return {};
+    std::swap(order[1], order[second]);
+    std::swap(order[2], order[third]);
+
+    Triangulator triangulator{points};
+    if (orient2d(points[order[0]], points[order[1]], points[order[2]]) > 0.0)
+        triangulator.init(order[0], order[1], order[2]);
+    else
+        triangulator.init(order[0], order[2], order[1]);
+    for (std::size_t i = 3; i != order.size(); ++i)
+        triangulator.insert(order[i]);
+    return triangulator.finish();
+}
+
+} // namespace CompGeom
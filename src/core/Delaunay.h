@@ -0,0 +1,46 @@
+#ifndef COMP_GEOM_CORE_DELAUNAY_H
+#define COMP_GEOM_CORE_DELAUNAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Neighbour of a triangle edge on the convex hull.
+constexpr std::uint32_t DelaunayNoNeighbour = 0xffffffffu;
+
+// Triangles as flat index arrays, three entries per triangle.
+struct DelaunayTriangulation {
+    // Indices into the input points, counterclockwise.
+    std::vector<std::uint32_t> triangles;
+    // Entry 3t + i is the triangle across the edge opposite vertex i of
+    // triangle t (from vertex i + 1 to i + 2), or DelaunayNoNeighbour.
+    std::vector<std::uint32_t> neighbours;
+
+    std::size_t size() const { return triangles.size() / 3; }
+};
+
+// Incremental Bowyer-Watson triangulation with exact predicates. Points are
+// inserted in BRIO order, random rounds of doubling size each sorted along a
+// Hilbert curve, so each insertion's walk starts next to the last one and
+// the triangles it touches are still in cache. Duplicate points are only
+// inserted once, the other copies appear in no triangle, and if all points
+// are collinear there are no triangles. At most 2^31 - 1 points.
+DelaunayTriangulation
+computeDelaunayTriangulation(Containers::ArrayView<const Vector2> points);
+
+// The BRIO insertion order used by computeDelaunayTriangulation().
+std::vector<std::uint32_t>
+computeBrioOrder(Containers::ArrayView<const Vector2> points);
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,215 @@
+#include "core/DensityPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Magnum/Math/Functions.h>
+
+#include "core/Parallel.h"
+
+namespace CompGeom {
+
+namespace {
+
+// Finest resolution, so a level's cells still fit 32 bit indices.
+constexpr std::uint32_t MaxSide = 1u << 15;
+
+// Points binned per chunk at least.
+constexpr std::size_t MinChunkPoints = 1u << 16;
+
+// Bands of rows per thread in the counting sort, for balance when the
+// points crowd into a few rows.
+constexpr std::size_t BandsPerThread = 4;
+
+// countInBox() sums cells at the finest level where the box spans at most
+// this many per side.
+constexpr float MaxCountCellsPerSide = 64.0f;
+
+} // namespace
+
+DensityPyramid::DensityPyramid(Containers::ArrayView<const Vector2> points,
+                               std::uint32_t resolution,
+                               unsigned threadCount) {
+    while (side_ < resolution && side_ < MaxSide)
+        side_ *= 2;
+    const std::size_t n = points.size();
+    const std::size_t cells = std::size_t(side_) * side_;
+    const std::size_t threads = resolveThreadCount(threadCount);
+    const std::size_t chunks =
+        std::max<std::size_t>(1, std::min(threads, n / MinChunkPoints));
+    const auto chunkBegin = [&](std::size_t chunk) {
+        return n * chunk / chunks;
+    };
+
+    // Bounding square of the points.
+    std::vector<Vector2> chunkMin(chunks, Vector2{0.0f}),
+        chunkMax(chunks, Vector2{0.0f});
+    parallelFor(chunks, threadCount, [&](std::size_t chunk, unsigned) {
+        const std::size_t begin = chunkBegin(chunk);
+        const std::size_t end = chunkBegin(chunk + 1);
+        if (begin == end)
+            return;
+        Vector2 min = points[begin], max = points[begin];
+        for (std::size_t i = begin + 1; i != end; ++i) {
+            min = Math::min(min, points[i]);
+            max = Math::max(max, points[i]);
+        }
+        chunkMin[chunk] = min;
+        chunkMax[chunk] = max;
+    });
+    Vector2 max;
+    min_ = max = n ? chunkMin[0] : Vector2{0.0f};
+    for (std::size_t chunk = 0; chunk != chunks; ++chunk) {
+        if (chunkBegin(chunk) == chunkBegin(chunk + 1))
+            continue;
+        min_ = Math::min(min_, chunkMin[chunk]);
+        max = Math::max(max, chunkMax[chunk]);
+    }
+    const float extent = (max - min_).max();
+    cellSize_ = extent > 0.0f ? extent / float(side_) : 1.0f;
+    const auto cellOf = [&](const Vector2& p) {
+        const Vector2 cell = (p - min_) / cellSize_;
+        const std::uint32_t x = std::min(side_ - 1, std::uint32_t(cell.x()));
+        const std::uint32_t y = std::min(side_ - 1, std::uint32_t(cell.y()));
+        return y * side_ + x;
+    };
+
+    // Counting sort by finest cell, partitioned into bands of rows so the
+    // only histograms are per chunk and band: each chunk scatters its
+    // points to their bands, then each band counts and scatters its own
+    // cells. The extra memory is two indices per point.
+    const std::size_t bandCells =
+        std::size_t(side_) *
+        ((side_ + threads * BandsPerThread - 1) / (threads * BandsPerThread));
+    const std::size_t bands = (cells + bandCells - 1) / bandCells;
+    std::vector<std::uint32_t> cellIndices(n);
+    std::vector<std::size_t> bandSlots(chunks * bands, 0);
+    parallelFor(chunks, threadCount, [&](std::size_t chunk, unsigned) {
+        std::size_t* slots = &bandSlots[chunk * bands];
+        for (std::size_t i = chunkBegin(chunk); i != chunkBegin(chunk + 1);
+             ++i) {
+            cellIndices[i] = cellOf(points[i]);
+            ++slots[cellIndices[i] / bandCells];
+        }
+    });
+    // Turned into each chunk's first slot in every band, bands in order.
+    std::vector<std::size_t> bandBegin(bands + 1);
+    std::size_t slot = 0;
+    for (std::size_t band = 0; band != bands; ++band) {
+        bandBegin[band] = slot;
+        for (std::size_t chunk = 0; chunk != chunks; ++chunk) {
+            const std::size_t count = bandSlots[chunk * bands + band];
+            bandSlots[chunk * bands + band] = slot;
+            slot += count;
+        }
+    }
+    bandBegin[bands] = slot;
+    std::vector<std::uint32_t> byBand(n);
+    parallelFor(chunks, threadCount, [&](std::size_t chunk, unsigned) {
+        std::size_t* slots = &bandSlots[chunk * bands];
+        for (std::size_t i = chunkBegin(chunk); i != chunkBegin(chunk + 1);
+             ++i)
+            byBand[slots[cellIndices[i] / bandCells]++] = std::uint32_t(i);
+    });
+
+    // A band owns its cells of the finest level and their offsets. While
+    // scattering, cellOffsets_[c + 1] is the next free slot of cell c and
+    // ends up as the first slot of cell c + 1.
+    levels_.emplace_back(cells);
+    std::vector<std::uint32_t>& finest = levels_.back();
+    cellOffsets_.resize(cells + 1);
+    cellOffsets_[0] = 0;
+    pointIndices_.resize(n);
+    parallelFor(bands, threadCount, [&](std::size_t band, unsigned) {
+        const std::size_t first = band * bandCells;
+        const std::size_t last = std::min(cells, first + bandCells);
+        for (std::size_t j = bandBegin[band]; j != bandBegin[band + 1]; ++j)
+            ++finest[cellIndices[byBand[j]]];
+        std::uint32_t offset = std::uint32_t(bandBegin[band]);
+        for (std::size_t c = first; c != last; ++c) {
+            cellOffsets_[c + 1] = offset;
+            offset += finest[c];
+        }
+        for (std::size_t j = bandBegin[band]; j != bandBegin[band + 1]; ++j) {
+            const std::uint32_t i = byBand[j];
+            pointIndices_[cellOffsets_[cellIndices[i] + 1]++] = i;
+        }
+    });
+
+    // Each coarser level sums 2x2 cells of the one before, a row at a time.
+    for (std::uint32_t side = side_ / 2; side != 0; side /= 2) {
+        std::vector<std::uint32_t> coarse(std::size_t(side) * side);
+        const std::vector<std::uint32_t>& fine = levels_.back();
+        parallelFor(side, threadCount, [&](std::size_t y, unsigned) {
+            const std::uint32_t* below = &fine[4 * y * side];
+            const std::uint32_t* above = below + 2 * side;
+            for (std::size_t x = 0; x != side; ++x)
+                coarse[y * side + x] = below[2 * x] + below[2 * x + 1] +
+                                       above[2 * x] + above[2 * x + 1];
+        });
+        levels_.push_back(std::move(coarse));
+    }
+
+    for (const std::vector<std::uint32_t>& level : levels_)
+        maxCounts_.push_back(*std::max_element(level.begin(), level.end()));
+}
+
+bool DensityPyramid::cellRange(float min, float max, float origin,
+                               std::size_t level, std::uint32_t& first,
+                               std::uint32_t& last) const {
+    const float size = cellSize(level);
+    const std::uint32_t cells = side(level);
+    if (max < origin || min > origin + size * float(cells))
+        return false;
+    const auto cell = [&](float v) {
+        return std::uint32_t(
+            Math::clamp(std::floor((v - origin) / size), 0.0f,
+                        float(cells - 1)));
+    };
+    first = cell(min);
+    last = cell(max);
+    return true;
+}
+
+std::size_t DensityPyramid::countInBox(const Vector2& min,
+                                       const Vector2& max) const {
+    const float extent = (max - min).max();
+    std::size_t level = 0;
+    while (level + 1 < levelCount() &&
+           extent > MaxCountCellsPerSide * cellSize(level))
+        ++level;
+
+    std::uint32_t x0, x1, y0, y1;
+    if (!cellRange(min.x(), max.x(), min_.x(), level, x0, x1) ||
+        !cellRange(min.y(), max.y(), min_.y(), level, y0, y1))
+        return 0;
+    const std::vector<std::uint32_t>& counts = levels_[level];
+    const std::size_t cells = side(level);
+    std::size_t total = 0;
+    for (std::uint32_t y = y0; y <= y1; ++y) {
+        for (std::uint32_t x = x0; x <= x1; ++x)
+            total += counts[y * cells + x];
+    }
+    return total;
+}
+
+void DensityPyramid::pointsInBox(const Vector2& min, const Vector2& max,
+                                 Containers::ArrayView<const Vector2> points,
+                                 std::vector<std::uint32_t>& out) const {
+    std::uint32_t x0, x1, y0, y1;
+    if (!cellRange(min.x(), max.x(), min_.x(), 0, x0, x1) ||
+        !cellRange(min.y(), max.y(), min_.y(), 0, y0, y1))
+        return;
+    for (std::uint32_t y = y0; y <= y1; ++y) {
+        const std::size_t row = std::size_t(y) * side_;
+        for (std::uint32_t i = cellOffsets_[row + x0];
+             i != cellOffsets_[row + x1 + 1]; ++i) {
+            const Vector2& p = points[pointIndices_[i]];
+            if (p.x() >= min.x() && p.x() <= max.x() && p.y() >= min.y() &&
+                p.y() <= max.y())
+                out.push_back(pointIndices_[i]);
+        }
+    }
+}
+
+} // namespace CompGeom
@@ -0,0 +1,75 @@
+#ifndef COMP_GEOM_CORE_DENSITYPYRAMID_H
+#define COMP_GEOM_CORE_DENSITYPYRAMID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Point counts on a square grid over the points' bounding square, at every
+// resolution from the given one down to a single cell, each level halving
+// the one before. Level 0 is the finest. Counts are row major, row 0 at the
+// lowest y. The points are also kept bucketed by their finest cell, so the
+// ones in a box are found without looking at the rest.
+class DensityPyramid {
+  public:
+    // Resolution is rounded up to a power of two, at most 2^15. The points
+    // are binned on threadCount threads (0 meaning one per hardware
+    // thread). At most 2^32 - 1 points.
+    explicit DensityPyramid(Containers::ArrayView<const Vector2> points,
+                            std::uint32_t resolution = 1024,
+                            unsigned threadCount = 0);
+
+    std::size_t levelCount() const { return levels_.size(); }
+    std::uint32_t side(std::size_t level) const { return side_ >> level; }
+    float cellSize(std::size_t level) const {
+        return cellSize_ * float(1u << level);
+    }
+    // Lower left corner of the grid.
+    const Vector2& min() const { return min_; }
+    Vector2 max() const { return min_ + Vector2{cellSize_ * float(side_)}; }
+
+    Containers::ArrayView<const std::uint32_t> counts(std::size_t level) const {
+        return levels_[level];
+    }
+    std::uint32_t maxCount(std::size_t level) const {
+        return maxCounts_[level];
+    }
+
+    // Upper bound of the points in the box from min to max, from the
+    // counts of the cells it touches at a level coarse enough to be cheap.
+    std::size_t countInBox(const Vector2& min, const Vector2& max) const;
+
+    // Appends the input indices of the points in the box from min to max.
+    void pointsInBox(const Vector2& min, const Vector2& max,
+                     Containers::ArrayView<const Vector2> points,
+                     std::vector<std::uint32_t>& out) const;
+
+  private:
+    // Range of cells of a level covering [min, max] on one axis, false if
+    // it misses the grid.
+    bool cellRange(float min, float max, float origin, std::size_t level,
+                   std::uint32_t& first, std::uint32_t& last) const;
+
+    Vector2 min_;
+    float cellSize_ = 1.0f;
+    std::uint32_t side_ = 1;
+    std::vector<std::vector<std::uint32_t>> levels_;
+    std::vector<std::uint32_t> maxCounts_;
+    // The points of finest cell i are pointIndices_[cellOffsets_[i]] up to
+    // pointIndices_[cellOffsets_[i + 1]].
+    std::vector<std::uint32_t> cellOffsets_;
+    std::vector<std::uint32_t> pointIndices_;
+};
+
+} // namespace CompGeom
+
+#endif
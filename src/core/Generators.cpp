@@ -0,0 +1,183 @@
+#include "core/Generators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "core/Parallel.h"
+
+namespace CompGeom {
+
+namespace {
+
+constexpr double Tau = 6.283185307179586;
+
+// SplitMix64 finalizer, a bijection that scrambles every input bit.
+std::uint64_t mix(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// Random numbers of element index, a pure function of the seed, the index
+// and which number k of the element is asked for.
+class ElementRandom {
+  public:
+    ElementRandom(std::uint64_t seed, std::size_t index)
+        : key_(mix(seed) + 16 * std::uint64_t(index)) {}
+
+    // Uniform in [0, 1).
+    double uniform(unsigned k) const {
+        return double(mix(key_ + k) >> 11) / 9007199254740992.0;
+    }
+
+    // Standard normal from uniform(k) and uniform(k + 1), Box-Muller.
+    double normal(unsigned k) const {
+        return std::sqrt(-2.0 * std::log(1.0 - uniform(k))) *
+               std::cos(Tau * uniform(k + 1));
+    }
+
+  private:
+    std::uint64_t key_;
+};
+
+// Calls fn(i) for every element, blocks of them spread over the threads.
+template <class F>
+void forEachElement(std::size_t count, unsigned threadCount, F&& fn) {
+    const std::size_t block = 1 << 16;
+    parallelFor((count + block - 1) / block, threadCount,
+                [&](std::size_t b, unsigned) {
+                    const std::size_t end = std::min(count, (b + 1) * block);
+                    for (std::size_t i = b * block; i < end; ++i)
+                        fn(i);
+                });
+}
+
+Vector2 point(double x, double y) { return Vector2{float(x), float(y)}; }
+
+Seg2 segment(double x0, double y0, double x1, double y1) {
+    return Seg2(point(x0, y0), point(x1, y1));
+}
+
+} // namespace
+
+std::vector<Vector2> generateRandomGridPoints2D(int number, int gridHeight,
+                                                std::uint64_t seed) {
+    std::vector<Vector2> points(std::size_t(std::max(number, 0)));
+    generatePoints(points, PointDistribution::Uniform, seed,
+                   float(gridHeight));
+    return points;
+}
+
+std::vector<Seg2> generateSegs(int number, int gridHeight,
+                               std::uint64_t seed) {
+    std::vector<Seg2> segs(std::size_t(std::max(number, 0)),
+                           Seg2(Vector2{}, Vector2{}));
+    generateSegments(segs, SegmentDistribution::CrossingPairs, seed,
+                     float(gridHeight));
+    return segs;
+}
+
+void generatePoints(Containers::ArrayView<Vector2> points,
+                    PointDistribution distribution, std::uint64_t seed,
+                    float extent, unsigned threadCount) {
+    const double e = extent;
+    forEachElement(points.size(), threadCount, [&](std::size_t i) {
+        const ElementRandom random{seed, i};
+        switch (distribution) {
+        case PointDistribution::Uniform:
+            points[i] = point(random.uniform(0) * e, random.uniform(1) * e);
+            return;
+        case PointDistribution::Circle: {
+            const double angle = Tau * random.uniform(0);
+            points[i] = point(e * 0.5 * (1.0 + std::cos(angle)),
+                              e * 0.5 * (1.0 + std::sin(angle)));
+            return;
+        }
+        case PointDistribution::GaussianClusters: {
+            // Sixteen clusters with centers away from the border.
+            const std::size_t cluster = std::size_t(random.uniform(0) * 16.0);
+            const ElementRandom center{~seed, cluster};
+            const double x = e * (0.125 + 0.75 * center.uniform(0)) +
+                             e / 64.0 * random.normal(1);
+            const double y = e * (0.125 + 0.75 * center.uniform(1)) +
+                             e / 64.0 * random.normal(3);
+            points[i] = point(std::min(std::max(x, 0.0), e),
+                              std::min(std::max(y, 0.0), e));
+            return;
+        }
+        }
+    });
+}
+
+void generateSegments(Containers::ArrayView<Seg2> segs,
+                      SegmentDistribution distribution, std::uint64_t seed,
+                      float extent, unsigned threadCount) {
+    const double e = extent;
+    const std::size_t n = segs.size();
+    // About two crossings per short segment.
+    const double shortLength =
+        2.0 * e / std::sqrt(double(std::max<std::size_t>(n, 1)));
+    const double columns = std::ceil(std::sqrt(double(n)));
+    const std::size_t horizontals = (n + 1) / 2;
+    forEachElement(n, threadCount, [&](std::size_t i) {
+        const ElementRandom random{seed, i};
+        const double u0 = random.uniform(0), u1 = random.uniform(1),
+                     u2 = random.uniform(2), u3 = random.uniform(3);
+        switch (distribution) {
+        case SegmentDistribution::CrossingPairs:
+            // Lower left to upper right, then upper left to lower right.
+            segs[i] = i % 2 == 0 ? segment(u0 * e / 2, u1 * e / 2,
+                                           e / 2 + u2 * e / 2,
+                                           e / 2 + u3 * e / 2)
+                                 : segment(u0 * e / 2, e / 2 + u1 * e / 2,
+                                           e / 2 + u2 * e / 2, u3 * e / 2);
+            return;
+        case SegmentDistribution::Short: {
+            const double angle = Tau * u2;
+            segs[i] = segment(u0 * e, u1 * e,
+                              u0 * e + shortLength * std::cos(angle),
+                              u1 * e + shortLength * std::sin(angle));
+            return;
+        }
+        case SegmentDistribution::Uniform:
+            segs[i] = segment(u0 * e, u1 * e, u2 * e, u3 * e);
+            return;
+        case SegmentDistribution::NearCollinear: {
+            // Overlapping pieces of one line, nudged off it by a few ulps.
+            const double x0 = u0 * e * 0.75, x1 = x0 + u1 * e * 0.25;
+            const double nudge = e * 1.0e-7 * random.normal(4);
+            segs[i] = segment(x0, e * 0.25 + 0.5 * x0 + nudge, x1,
+                              e * 0.25 + 0.5 * x1 - nudge);
+            return;
+        }
+        case SegmentDistribution::Vertical: {
+            // Every other one vertical on one of about sqrt(n) shared x,
+            // so some of them overlap, the rest short ones in any direction.
+            if (i % 2 == 0) {
+                const double x = e * (0.5 + std::floor(u0 * columns)) / columns;
+                const double y = u1 * (e - shortLength);
+                segs[i] = segment(x, y, x, y + shortLength);
+            } else {
+                const double angle = Tau * u2;
+                segs[i] = segment(u0 * e, u1 * e,
+                                  u0 * e + shortLength * std::cos(angle),
+                                  u1 * e + shortLength * std::sin(angle));
+            }
+            return;
+        }
+        case SegmentDistribution::Grid:
+            if (i < horizontals) {
+                const double y = e * (double(i) + 0.5) / double(horizontals);
+                segs[i] = segment(0.0, y, e, y);
+            } else {
+                const double x = e * (double(i - horizontals) + 0.5) /
+                                 double(n - horizontals);
+                segs[i] = segment(x, 0.0, x, e);
+            }
+            return;
+        }
+    });
+}
+
+} // namespace CompGeom
@@ -0,0 +1,61 @@
+#ifndef COMP_GEOM_CORE_GENERATORS_H
+#define COMP_GEOM_CORE_GENERATORS_H
+
+#include <cstdint>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Seg2.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Seed used when none is given, so runs are reproducible by default.
+constexpr std::uint64_t DefaultGeneratorSeed = 0x5eed;
+
+// Uniformly random points in the [0, gridHeight] square.
+std::vector<Vector2> generateRandomGridPoints2D(
+    int number, int gridHeight = 10,
+    std::uint64_t seed = DefaultGeneratorSeed);
+
+// Random segments generated in pairs that probably overlap.
+std::vector<Seg2> generateSegs(int number, int gridHeight = 10,
+                               std::uint64_t seed = DefaultGeneratorSeed);
+
+// Point workloads, each stressing a different hull algorithm.
+enum class PointDistribution {
+    Uniform,         // Uniform in the square, h grows like log n.
+    Circle,          // On a circle, every point is on the hull (h = n).
+    GaussianClusters // Tight clusters, most points deep inside the hull.
+};
+
+// Segment workloads, each stressing a different intersection backend.
+enum class SegmentDistribution {
+    CrossingPairs, // Pairs that probably cross, as generateSegs().
+    Short,         // Short, so k grows linearly with n.
+    Uniform,       // Endpoints anywhere in the square, k grows like n^2.
+    NearCollinear, // Along almost the same line, stressing the predicates.
+    Vertical,      // Short verticals on shared x, crossed by short others.
+    Grid           // Full width horizontals and verticals, k = n^2 / 4.
+};
+
+// Fill the whole buffer inside the [0, extent] square on threadCount
+// threads (0 meaning one per hardware thread). Element i only depends on
+// the seed, i and the buffer size, from a counter based random generator,
+// so the result is the same for any thread count.
+void generatePoints(Containers::ArrayView<Vector2> points,
+                    PointDistribution distribution,
+                    std::uint64_t seed = DefaultGeneratorSeed,
+                    float extent = 1000.0f, unsigned threadCount = 0);
+void generateSegments(Containers::ArrayView<Seg2> segs,
+                      SegmentDistribution distribution,
+                      std::uint64_t seed = DefaultGeneratorSeed,
+                      float extent = 1000.0f, unsigned threadCount = 0);
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,254 @@
+#include "core/GeometryFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Corrade/Utility/Debug.h>
+
+namespace CompGeom {
+
+// The views reinterpret the packed coordinates in place.
+static_assert(sizeof(Vector2) == 2 * sizeof(float) &&
+                  sizeof(Vector2d) == 2 * sizeof(double) &&
+                  sizeof(Seg2) == 4 * sizeof(float),
+              "Vector2 and Seg2 are not tightly packed");
+static_assert(std::is_standard_layout<Seg2>::value,
+              "Seg2 can't be viewed in place");
+
+namespace {
+
+constexpr char Magic[4] = {'C', 'G', 'E', 'O'};
+
+// Bytes of one point or segment.
+std::size_t stride(GeometryFileKind kind, GeometryFileScalar scalar) {
+    return (kind == GeometryFileKind::Points ? 2 : 4) * std::size_t(scalar);
+}
+
+bool write(const std::string& path, GeometryFileKind kind,
+           GeometryFileScalar scalar, std::size_t count, const void* data) {
+    GeometryFileHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = GeometryFileVersion;
+    header.kind = kind;
+    header.scalar = scalar;
+    header.count = count;
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        Error{} << "CompGeom::writeGeometryFile(): can't open" << path;
+        return false;
+    }
+    const std::size_t bytes = count * stride(kind, scalar);
+    const bool written =
+        std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        (bytes == 0 || std::fwrite(data, bytes, 1, file) == 1);
+    if (std::fclose(file) != 0 || !written) {
+        Error{} << "CompGeom::writeGeometryFile(): can't write" << path;
+        return false;
+    }
+    return true;
+}
+
+// Whether the header is one this version can read, printing why not.
+bool checkHeader(const GeometryFileHeader& header, const char* function,
+                 const std::string& path) {
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) {
+        Error{} << function << path << "is not a geometry file";
+        return false;
+    }
+    // A file from a machine of the other byte order reads as a different
+    // version.
+    if (header.version != GeometryFileVersion) {
+        Error{} << function << "unsupported version" << header.version << "in"
+                << path;
+        return false;
+    }
+    if ((header.kind != GeometryFileKind::Points &&
+         header.kind != GeometryFileKind::Segments) ||
+        (header.scalar != GeometryFileScalar::Float &&
+         header.scalar != GeometryFileScalar::Double)) {
+        Error{} << function << "unknown data in" << path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool writeGeometryFile(const std::string& path,
+                       Containers::ArrayView<const Vector2> points) {
+    return write(path, GeometryFileKind::Points, GeometryFileScalar::Float,
+                 points.size(), points.data());
+}
+
+bool writeGeometryFile(const std::string& path,
+                       Containers::ArrayView<const Vector2d> points) {
+    return write(path, GeometryFileKind::Points, GeometryFileScalar::Double,
+                 points.size(), points.data());
+}
+
+bool writeGeometryFile(const std::string& path,
+                       Containers::ArrayView<const Seg2> segs) {
+    return write(path, GeometryFileKind::Segments, GeometryFileScalar::Float,
+                 segs.size(), segs.data());
+}
+
+bool writeGeometryFileSegments(
+    const std::string& path, Containers::ArrayView<const Vector2d> endpoints) {
+    if (endpoints.size() % 2 != 0) {
+        Error{} << "CompGeom::writeGeometryFileSegments(): odd number of"
+                << "endpoints";
+        return false;
+    }
+    return write(path, GeometryFileKind::Segments, GeometryFileScalar::Double,
+                 endpoints.size() / 2, endpoints.data());
+}
+
+Containers::Optional<MappedGeometryFile>
+MappedGeometryFile::open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        Error{} << "CompGeom::MappedGeometryFile::open(): can't open" << path;
+        return Containers::NullOpt;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        std::size_t(info.st_size) < sizeof(GeometryFileHeader)) {
+        ::close(fd);
+        Error{} << "CompGeom::MappedGeometryFile::open():" << path
+                << "is too short for a geometry file";
+        return Containers::NullOpt;
+    }
+    const std::size_t size = std::size_t(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        Error{} << "CompGeom::MappedGeometryFile::open(): can't map" << path;
+        return Containers::NullOpt;
+    }
+    MappedGeometryFile file{data, size};
+
+    const GeometryFileHeader& header = file.header();
+    if (!checkHeader(header, "CompGeom::MappedGeometryFile::open():", path))
+        return Containers::NullOpt;
+    const std::size_t payload = size - sizeof(GeometryFileHeader);
+    const std::size_t bytes = stride(header.kind, header.scalar);
+    if (header.count != payload / bytes || payload % bytes != 0) {
+        Error{} << "CompGeom::MappedGeometryFile::open():" << path << "has"
+                << payload << "bytes of data, expected" << header.count
+                << "items of" << bytes;
+        return Containers::NullOpt;
+    }
+    return Containers::Optional<MappedGeometryFile>{std::move(file)};
+}
+
+MappedGeometryFile::MappedGeometryFile(MappedGeometryFile&& other) noexcept
+    : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedGeometryFile::~MappedGeometryFile() {
+    if (data_)
+        munmap(const_cast<void*>(data_), size_);
+}
+
+MappedGeometryFile&
+MappedGeometryFile::operator=(MappedGeometryFile&& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+}
+
+Containers::ArrayView<const Vector2> MappedGeometryFile::points() const {
+    if (kind() != GeometryFileKind::Points ||
+        scalar() != GeometryFileScalar::Float)
+        return nullptr;
+    return {static_cast<const Vector2*>(payload()), size()};
+}
+
+Containers::ArrayView<const Vector2d> MappedGeometryFile::pointsDouble() const {
+    if (kind() != GeometryFileKind::Points ||
+        scalar() != GeometryFileScalar::Double)
+        return nullptr;
+    return {static_cast<const Vector2d*>(payload()), size()};
+}
+
+Containers::ArrayView<const Seg2> MappedGeometryFile::segments() const {
+    if (kind() != GeometryFileKind::Segments ||
+        scalar() != GeometryFileScalar::Float)
+        return nullptr;
+    return {static_cast<const Seg2*>(payload()), size()};
+}
+
+Containers::ArrayView<const Vector2d>
+MappedGeometryFile::segmentEndpointsDouble() const {
+    if (kind() != GeometryFileKind::Segments ||
+        scalar() != GeometryFileScalar::Double)
+        return nullptr;
+    return {static_cast<const Vector2d*>(payload()), 2 * size()};
+}
+
+Containers::Optional<GeometryFileReader>
+GeometryFileReader::open(std::FILE* file, const std::string& name) {
+    GeometryFileReader reader{file, name};
+    if (std::fread(&reader.header_, sizeof(reader.header_), 1, file) != 1) {
+        Error{} << "CompGeom::GeometryFileReader::open(): can't read the"
+                << "header of" << name;
+        return Containers::NullOpt;
+    }
+    if (!checkHeader(reader.header_, "CompGeom::GeometryFileReader::open():",
+                     name))
+        return Containers::NullOpt;
+    reader.remaining_ = std::size_t(reader.header_.count);
+    return reader;
+}
+
+bool GeometryFileReader::readPoints(std::vector<Vector2>& points,
+                                    std::size_t maxCount) {
+    points.clear();
+    if (header_.kind != GeometryFileKind::Points) {
+        Error{} << "CompGeom::GeometryFileReader::readPoints():" << name_
+                << "holds segments";
+        return false;
+    }
+    const std::size_t count = std::min(maxCount, remaining_);
+    std::size_t read;
+    if (header_.scalar == GeometryFileScalar::Float) {
+        points.resize(count);
+        read = std::fread(points.data(), sizeof(Vector2), count, file_);
+        points.resize(read);
+    } else {
+        // Converted in small blocks, so the buffer of doubles stays small.
+        Vector2d block[256];
+        read = 0;
+        while (read < count) {
+            const std::size_t want = std::min(count - read, std::size_t(256));
+            const std::size_t got =
+                std::fread(block, sizeof(Vector2d), want, file_);
+            for (std::size_t i = 0; i < got; ++i)
+                points.push_back(Vector2{block[i]});
+            read += got;
+            if (got != want)
+                break;
+        }
+    }
+    remaining_ -= read;
+    if (read != count) {
+        Error{} << "CompGeom::GeometryFileReader::readPoints():" << name_
+                << "ended" << remaining_ << "points early";
+        return false;
+    }
+    return true;
+}
+
+} // namespace CompGeom
@@ -0,0 +1,138 @@
+#ifndef COMP_GEOM_CORE_GEOMETRYFILE_H
+#define COMP_GEOM_CORE_GEOMETRYFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Seg2.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Binary file of points or segments: a 32 byte header, then the coordinates
+// tightly packed, x y per point and p.x p.y q.x q.y per segment, in the byte
+// order of the machine that wrote it. The header keeps the data aligned for
+// doubles, so a mapped file can be used in place.
+enum class GeometryFileKind : std::uint8_t { Points = 1, Segments = 2 };
+
+// Size in bytes of one coordinate.
+enum class GeometryFileScalar : std::uint8_t { Float = 4, Double = 8 };
+
+constexpr std::uint16_t GeometryFileVersion = 1;
+
+struct GeometryFileHeader {
+    char magic[4]; // "CGEO"
+    std::uint16_t version;
+    GeometryFileKind kind;
+    GeometryFileScalar scalar;
+    std::uint64_t count; // Points or segments
+    std::uint64_t reserved[2];
+};
+
+static_assert(sizeof(GeometryFileHeader) == 32,
+              "GeometryFileHeader is not tightly packed");
+
+// Writes a point or segment file, false with a message on Error output if
+// it can't be written.
+bool writeGeometryFile(const std::string& path,
+                       Containers::ArrayView<const Vector2> points);
+bool writeGeometryFile(const std::string& path,
+                       Containers::ArrayView<const Vector2d> points);
+bool writeGeometryFile(const std::string& path,
+                       Containers::ArrayView<const Seg2> segs);
+
+// Double segments, passed as their endpoints in pairs.
+bool writeGeometryFileSegments(const std::string& path,
+                               Containers::ArrayView<const Vector2d> endpoints);
+
+// A geometry file mapped read only into memory. The views point straight
+// into the mapping, so the algorithms can run on a float file without
+// parsing or copying it, and the OS pages it in as they go. They take float
+// data only, double files have to be rounded into a copy first. Only valid
+// while the MappedGeometryFile is alive.
+class MappedGeometryFile {
+  public:
+    // NullOpt with a message on Error output if the file can't be mapped,
+    // isn't a geometry file, has a newer version or another byte order, or
+    // its size doesn't match the header.
+    static Containers::Optional<MappedGeometryFile>
+    open(const std::string& path);
+
+    MappedGeometryFile(const MappedGeometryFile&) = delete;
+    MappedGeometryFile(MappedGeometryFile&& other) noexcept;
+    ~MappedGeometryFile();
+
+    MappedGeometryFile& operator=(const MappedGeometryFile&) = delete;
+    MappedGeometryFile& operator=(MappedGeometryFile&& other) noexcept;
+
+    GeometryFileKind kind() const { return header().kind; }
+    GeometryFileScalar scalar() const { return header().scalar; }
+
+    // Number of points or segments.
+    std::size_t size() const { return std::size_t(header().count); }
+
+    // The data, empty unless the file holds that kind and scalar. Double
+    // segments are viewed as their endpoints, p and q of segment i at 2i
+    // and 2i + 1.
+    Containers::ArrayView<const Vector2> points() const;
+    Containers::ArrayView<const Vector2d> pointsDouble() const;
+    Containers::ArrayView<const Seg2> segments() const;
+    Containers::ArrayView<const Vector2d> segmentEndpointsDouble() const;
+
+  private:
+    MappedGeometryFile(const void* data, std::size_t size)
+        : data_(data), size_(size) {}
+
+    const GeometryFileHeader& header() const {
+        return *static_cast<const GeometryFileHeader*>(data_);
+    }
+
+    const void* payload() const {
+        return static_cast<const char*>(data_) + sizeof(GeometryFileHeader);
+    }
+
+    const void* data_;
+    std::size_t size_;
+};
+
+// Reads a geometry file front to back with plain reads instead of mapping
+// it, for pipes and for keeping only a bounded part of it in memory.
+class GeometryFileReader {
+  public:
+    // Reads and checks the header, NullOpt with a message on Error output if
+    // it isn't valid. The file stays owned by the caller, name is only used
+    // in messages.
+    static Containers::Optional<GeometryFileReader>
+    open(std::FILE* file, const std::string& name);
+
+    const GeometryFileHeader& header() const { return header_; }
+
+    // Points or segments not read yet.
+    std::size_t remaining() const { return remaining_; }
+
+    // Replaces points with up to maxCount more points of a point file,
+    // double ones rounded to float. False with a message on Error output if
+    // the file holds segments or ends early.
+    bool readPoints(std::vector<Vector2>& points, std::size_t maxCount);
+
+  private:
+    GeometryFileReader(std::FILE* file, const std::string& name)
+        : file_(file), name_(name) {}
+
+    std::FILE* file_;
+    std::string name_;
+    GeometryFileHeader header_;
+    std::size_t remaining_ = 0;
+};
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,446 @@
+#include "core/Hull.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <Corrade/Utility/Debug.h>
+
+#include "core/GeometryFile.h"
+#include "core/Parallel.h"
+#include "core/Predicates.h"
+
+namespace CompGeom {
+
+namespace {
+
+bool lexLess(const Vector2& lhs, const Vector2& rhs) {
+    return lhs.x() < rhs.x() || (lhs.x() == rhs.x() && lhs.y() < rhs.y());
+}
+
+// Positive if c is left of the directed line a -> b, with an exact sign.
+double orient(const Vector2& a, const Vector2& b, const Vector2& c) {
+    return orient2d(a, b, c);
+}
+
+// Counter clockwise, strictly convex hull of the points starting at the
+// lexicographically smallest one. The points are sorted and deduplicated in
+// place.
+std::vector<Vector2> monotoneChainCCW(std::vector<Vector2>& points) {
+    std::sort(points.begin(), points.end(), lexLess);
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() <= 1)
+        return {points.begin(), points.end()};
+
+    std::vector<Vector2> hull(2 * points.size());
+    std::size_t k = 0;
+    // Lower chain, left to right.
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        while (k >= 2 && orient(hull[k - 2], hull[k - 1], points[i]) <= 0.0)
+            --k;
+        hull[k++] = points[i];
+    }
+    // Upper chain, right to left.
+    for (std::size_t i = points.size() - 1, t = k + 1; i > 0; --i) {
+        while (k >= t &&
+               orient(hull[k - 2], hull[k - 1], points[i - 1]) <= 0.0)
+            --k;
+        hull[k++] = points[i - 1];
+    }
+    // Last point is the first one again.
+    hull.resize(k - 1);
+    return hull;
+}
+
+// Turns a counter clockwise vertex list into the closed clockwise polyline
+// returned by all the hull functions.
+std::vector<Vector2> closedClockwise(const std::vector<Vector2>& ccw) {
+    std::vector<Vector2> hull;
+    hull.reserve(ccw.size() + 1);
+    hull.push_back(ccw.front());
+    hull.insert(hull.end(), ccw.rbegin(), ccw.rend() - 1);
+    hull.push_back(ccw.front());
+    return hull;
+}
+
+// True if candidate should replace best as the next counter clockwise wrap
+// point from p, i.e. it is right of p -> best, or collinear and further away.
+bool betterWrap(const Vector2& p, const Vector2& best,
+                const Vector2& candidate) {
+    const double o = orient(p, best, candidate);
+    return o < 0.0 ||
+           (o == 0.0 && (candidate - p).dot() > (best - p).dot());
+}
+
+// Index of the vertex of the counter clockwise hull h with all of h left of
+// p -> h[i], picking the furthest one on ties. Returns -1 if every vertex is
+// p. Linear scan, used for tiny hulls and as fallback.
+int tangentLinear(const Vector2* h, int n, const Vector2& p) {
+    int best = -1;
+    for (int i = 0; i < n; ++i) {
+        if (h[i] == p)
+            continue;
+        if (best < 0 || betterWrap(p, h[best], h[i]))
+            best = i;
+    }
+    return best;
+}
+
+// Same as tangentLinear() in O(log n), binary searching the hull following
+// Dan Sunday's tangent_PointPolyC(). Degenerate configurations (p on the hull
+// or collinear with an edge) are caught by checking the result against its
+// neighbours and fall back to the linear scan.
+int tangent(const Vector2* h, int n, const Vector2& p) {
+    if (n <= 3)
+        return tangentLinear(h, n, p);
+
+    auto at = [&](int i) -> const Vector2& { return h[((i % n) + n) % n]; };
+    // Vi is above Vj if Vj is left of p -> Vi.
+    auto above = [&](int i, int j) { return orient(p, at(i), at(j)) > 0.0; };
+    auto below = [&](int i, int j) { return orient(p, at(i), at(j)) < 0.0; };
+
+    int found = -1;
+    if (below(1, 0) && !above(n - 1, 0)) {
+        found = 0;
+    } else {
+        int a = 0, b = n;
+        while (b - a > 1) {
+            const int c = (a + b) / 2;
+            const bool dnC = below(c + 1, c);
+            if (dnC && !above(c - 1, c)) {
+                found = c;
+                break;
+            }
+            if (above(a + 1, a)) {
+                if (dnC || above(a, c))
+                    b = c;
+                else
+                    a = c;
+            } else {
+                if (dnC && below(a, c))
+                    b = c;
+                else
+                    a = c;
+            }
+        }
+    }
+
+    // Check it is a proper tangent, then step onto a further collinear
+    // neighbour if there is one.
+    if (found < 0 || at(found) == p ||
+        orient(p, at(found), at(found + 1)) < 0.0 ||
+        orient(p, at(found), at(found - 1)) < 0.0)
+        return tangentLinear(h, n, p);
+    for (int step : {1, -1}) {
+        const int other = (found + step + n) % n;
+        if (orient(p, at(found), at(other)) == 0.0 &&
+            (at(other) - p).dot() > (at(found) - p).dot())
+            found = other;
+    }
+    return found;
+}
+
+// Gift wraps clockwise from the leftmost (then lowest) point, passing every
+// hull vertex to emit as soon as it is found and keeping nothing else. Stops
+// when emit returns false, returns whether the wrap got all the way round.
+template <class F>
+bool giftWrap(Containers::ArrayView<const Vector2> points, F&& emit) {
+    // Initial point on hull is the leftmost point.
+    const Vector2 first =
+        *std::min_element(points.begin(), points.end(), lexLess);
+
+    // Loop till wrap around to first hull point.
+    Vector2 pointOnHull = first;
+    do {
+        if (!emit(pointOnHull))
+            return false;
+        // Temp endpoint
+        Vector2 endpoint = first;
+        // Nest loop over all points
+        for (size_t i = 0; i < points.size(); ++i) {
+            const double o = endpoint == pointOnHull
+                                 ? 1.0
+                                 : orient(pointOnHull, endpoint, points[i]);
+            // Found greater left turn updated endpoint. Of collinear points
+            // the furthest, so points inside a hull edge are skipped as the
+            // other algorithms do.
+            if (o > 0.0 ||
+                (o == 0.0 && (points[i] - pointOnHull).dot() >
+                                 (endpoint - pointOnHull).dot()))
+                endpoint = points[i];
+        }
+        pointOnHull = endpoint;
+    } while (pointOnHull != first);
+    return true;
+}
+
+std::vector<Vector2> runHull(Containers::ArrayView<const Vector2> points,
+                             HullAlgorithm algorithm) {
+    switch (algorithm) {
+    case HullAlgorithm::JarvisMarch:
+        return compute2DConvexHullJarvisMarch(points);
+    case HullAlgorithm::MonotoneChain:
+        return compute2DConvexHullMonotoneChain(points);
+    case HullAlgorithm::Chan:
+        return compute2DConvexHullChan(points);
+    case HullAlgorithm::Parallel:
+        return compute2DConvexHullParallel(points);
+    }
+    return compute2DConvexHullChan(points);
+}
+
+} // namespace
+
+std::vector<Vector2>
+computeConvexHull2D(Containers::ArrayView<const Vector2> points,
+                    HullAlgorithm algorithm, HullPrefilter prefilter,
+                    std::size_t* prefilterRemoved) {
+    if (prefilterRemoved)
+        *prefilterRemoved = 0;
+
+    if (prefilter != HullPrefilter::None && points.size() > 3) {
+        std::vector<Vector2> kept;
+        const std::size_t removed =
+            aklToussaintPrefilter(points, kept, prefilter);
+        // With three or fewer points left the hull functions would return
+        // them as is instead of closed, so hull the full input then.
+        if (kept.size() > 3) {
+            if (prefilterRemoved)
+                *prefilterRemoved = removed;
+            return runHull(kept, algorithm);
+        }
+    }
+    return runHull(points, algorithm);
+}
+
+std::vector<Vector2>
+compute2DConvexHullJarvisMarch(Containers::ArrayView<const Vector2> points) {
+    // Simple case anything less than triangle.
+    if (points.size() <= 3)
+        return {points.begin(), points.end()};
+
+    std::vector<Vector2> hull;
+    giftWrap(points, [&](const Vector2& vertex) {
+        hull.push_back(vertex);
+        return true;
+    });
+
+    // Append front point again to close segment
+    hull.push_back(hull.front());
+
+    return hull;
+}
+
+void forEachConvexHullVertex(Containers::ArrayView<const Vector2> points,
+                             const HullVertexCallback& callback,
+                             HullAlgorithm algorithm,
+                             HullPrefilter prefilter) {
+    if (algorithm != HullAlgorithm::JarvisMarch || points.size() <= 3) {
+        for (const Vector2& vertex :
+             computeConvexHull2D(points, algorithm, prefilter)) {
+            if (!callback(vertex))
+                return;
+        }
+        return;
+    }
+
+    // Gift wrapping finds the vertices in output order, pass them on as
+    // they come.
+    std::vector<Vector2> kept;
+    if (prefilter != HullPrefilter::None)
+        aklToussaintPrefilter(points, kept, prefilter);
+    const Containers::ArrayView<const Vector2> input =
+        kept.size() > 3 ? Containers::ArrayView<const Vector2>{kept} : points;
+    Vector2 first;
+    bool started = false;
+    const bool wrapped = giftWrap(input, [&](const Vector2& vertex) {
+        if (!started) {
+            first = vertex;
+            started = true;
+        }
+        return callback(vertex);
+    });
+    if (wrapped)
+        callback(first);
+}
+
+std::size_t countConvexHullVertices(Containers::ArrayView<const Vector2> points,
+                                    HullAlgorithm algorithm,
+                                    HullPrefilter prefilter) {
+    if (points.size() <= 3)
+        return points.size();
+    std::size_t count = 0;
+    forEachConvexHullVertex(points,
+                            [&](const Vector2&) {
+                                ++count;
+                                return true;
+                            },
+                            algorithm, prefilter);
+    // Without the point repeated to close the polyline.
+    return count - 1;
+}
+
+std::vector<Vector2>
+compute2DConvexHullMonotoneChain(Containers::ArrayView<const Vector2> points) {
+    if (points.size() <= 3)
+        return {points.begin(), points.end()};
+
+    std::vector<Vector2> sorted(points.begin(), points.end());
+    return closedClockwise(monotoneChainCCW(sorted));
+}
+
+std::vector<Vector2>
+compute2DConvexHullChan(Containers::ArrayView<const Vector2> points) {
+    if (points.size() <= 3)
+        return {points.begin(), points.end()};
+
+    const std::size_t n = points.size();
+    const Vector2 start =
+        *std::min_element(points.begin(), points.end(), lexLess);
+
+    std::vector<Vector2> group;
+    std::vector<Vector2> groupHulls;
+    std::vector<std::size_t> offsets;
+    for (unsigned t = 1;; ++t) {
+        // Group size m = 2^(2^t), capped at n. The last round always
+        // succeeds as it is a single monotone chain.
+        const std::size_t m =
+            t >= 6 || (std::size_t(1) << (1u << t)) >= n
+                ? n
+                : std::size_t(1) << (1u << t);
+
+        // Hull every group of m points.
+        groupHulls.clear();
+        offsets.assign(1, 0);
+        for (std::size_t begin = 0; begin < n; begin += m) {
+            group.assign(points.begin() + begin,
+                         points.begin() + std::min(begin + m, n));
+            const std::vector<Vector2> h = monotoneChainCCW(group);
+            groupHulls.insert(groupHulls.end(), h.begin(), h.end());
+            offsets.push_back(groupHulls.size());
+        }
+
+        // Wrap counter clockwise around the group hulls for at most m steps.
+        std::vector<Vector2> ccw{start};
+        Vector2 current = start;
+        bool closed = false;
+        for (std::size_t step = 0; step < m && !closed; ++step) {
+            bool found = false;
+            Vector2 best;
+            for (std::size_t g = 0; g + 1 < offsets.size(); ++g) {
+                const Vector2* h = groupHulls.data() + offsets[g];
+                const int i =
+                    tangent(h, int(offsets[g + 1] - offsets[g]), current);
+                if (i < 0)
+                    continue;
+                if (!found || betterWrap(current, best, h[i])) {
+                    best = h[i];
+                    found = true;
+                }
+            }
+            // All points coincide with the start.
+            if (!found || best == start) {
+                closed = true;
+                break;
+            }
+            ccw.push_back(best);
+            current = best;
+        }
+
+        if (closed)
+            return closedClockwise(ccw);
+    }
+}
+
+std::vector<Vector2>
+compute2DConvexHullParallel(Containers::ArrayView<const Vector2> points,
+                            unsigned threadCount) {
+    if (points.size() <= 3)
+        return {points.begin(), points.end()};
+
+    // Keep chunks big enough that spawning a thread is worth it.
+    const std::size_t minChunk = 4096;
+    const std::size_t chunks = std::max<std::size_t>(
+        1, std::min<std::size_t>(resolveThreadCount(threadCount),
+                                 points.size() / minChunk));
+    const std::size_t chunkSize = (points.size() + chunks - 1) / chunks;
+
+    // Hull each chunk on its own thread.
+    std::vector<std::vector<Vector2>> chunkHulls(chunks);
+    parallelFor(chunks, unsigned(chunks), [&](std::size_t i, unsigned) {
+        const std::size_t begin = i * chunkSize;
+        const std::size_t end = std::min(begin + chunkSize, points.size());
+        std::vector<Vector2> chunk(points.begin() + begin,
+                                   points.begin() + end);
+        chunkHulls[i] = monotoneChainCCW(chunk);
+    });
+
+    // Merge, the overall hull is the hull of the chunk hull vertices.
+    std::vector<Vector2> merged;
+    for (const std::vector<Vector2>& h : chunkHulls)
+        merged.insert(merged.end(), h.begin(), h.end());
+    return closedClockwise(monotoneChainCCW(merged));
+}
+
+StreamingConvexHull2D::StreamingConvexHull2D(std::size_t chunkSize)
+    : chunkSize_(std::max<std::size_t>(chunkSize, 1)) {}
+
+void StreamingConvexHull2D::add(const Vector2& point) {
+    points_.push_back(point);
+    ++pointCount_;
+    // Three or fewer points are returned as given, keep them until then.
+    if (points_.size() - hullSize_ >= chunkSize_ && pointCount_ > 3)
+        merge();
+}
+
+void StreamingConvexHull2D::add(Containers::ArrayView<const Vector2> points) {
+    for (const Vector2& point : points)
+        add(point);
+}
+
+void StreamingConvexHull2D::merge() {
+    // The hull of the running hull and the new points is the new hull.
+    points_ = monotoneChainCCW(points_);
+    hullSize_ = points_.size();
+}
+
+std::vector<Vector2> StreamingConvexHull2D::hull() {
+    if (pointCount_ <= 3)
+        return points_;
+    if (points_.size() > hullSize_)
+        merge();
+    return closedClockwise(points_);
+}
+
+Containers::Optional<std::vector<Vector2>>
+computeConvexHull2DStreaming(const std::string& path, std::size_t chunkSize) {
+    const bool standardInput = path == "-";
+    std::FILE* file = standardInput ? stdin : std::fopen(path.c_str(), "rb");
+    if (!file) {
+        Error{} << "CompGeom::computeConvexHull2DStreaming(): can't open"
+                << path;
+        return Containers::NullOpt;
+    }
+
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    Containers::Optional<std::vector<Vector2>> result;
+    Containers::Optional<GeometryFileReader> reader =
+        GeometryFileReader::open(file, path);
+    if (reader) {
+        StreamingConvexHull2D hull{chunkSize};
+        std::vector<Vector2> chunk;
+        chunk.reserve(std::min(chunkSize, reader->remaining()));
+        bool ok = true;
+        while (ok && reader->remaining() != 0) {
+            ok = reader->readPoints(chunk, chunkSize);
+            hull.add(chunk);
+        }
+        if (ok)
+            result = hull.hull();
+    }
+
+    if (!standardInput)
+        std::fclose(file);
+    return result;
+}
+
+} // namespace CompGeom
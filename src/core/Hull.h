@@ -0,0 +1,126 @@
+#ifndef COMP_GEOM_CORE_HULL_H
+#define COMP_GEOM_CORE_HULL_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/HullPrefilter.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Selects the algorithm used by computeConvexHull2D().
+enum class HullAlgorithm {
+    JarvisMarch,   // O(n h) gift wrap.
+    MonotoneChain, // O(n log n) Andrew's monotone chain.
+    Chan,          // O(n log h) output sensitive.
+    Parallel       // Monotone chain over per thread chunks, then merged.
+};
+
+// All hull functions return the same format: a closed polyline (the first
+// point is repeated at the end) going clockwise from the leftmost (then
+// lowest) point, with no duplicate points and none inside a hull edge.
+// Inputs with three or fewer points are returned unchanged.
+
+// Computes the hull with the selected algorithm, first dropping interior
+// points with the Akl-Toussaint prefilter unless it is None. The number of
+// points the prefilter removed is written to prefilterRemoved if given.
+std::vector<Vector2>
+computeConvexHull2D(Containers::ArrayView<const Vector2> points,
+                    HullAlgorithm algorithm = HullAlgorithm::Chan,
+                    HullPrefilter prefilter = HullPrefilter::EightDirections,
+                    std::size_t* prefilterRemoved = nullptr);
+
+// Called with the hull vertices in the order of the closed polyline the
+// other functions return. Returning false stops.
+typedef std::function<bool(const Vector2& vertex)> HullVertexCallback;
+
+// Streams the hull to callback instead of returning it. Jarvis march finds
+// the vertices in output order with no memory beyond the input, so they are
+// passed on as found and stopping early also stops the work. The other
+// algorithms need the hull (not the input) as working memory before it can
+// be streamed.
+void forEachConvexHullVertex(
+    Containers::ArrayView<const Vector2> points,
+    const HullVertexCallback& callback,
+    HullAlgorithm algorithm = HullAlgorithm::Chan,
+    HullPrefilter prefilter = HullPrefilter::EightDirections);
+
+// Number of hull vertices, without the point repeated to close the polyline.
+// Inputs with three or fewer points count as they are.
+std::size_t countConvexHullVertices(
+    Containers::ArrayView<const Vector2> points,
+    HullAlgorithm algorithm = HullAlgorithm::Chan,
+    HullPrefilter prefilter = HullPrefilter::EightDirections);
+
+// Gift wrap the points.
+std::vector<Vector2>
+compute2DConvexHullJarvisMarch(Containers::ArrayView<const Vector2> points);
+
+// Sort the points and build the upper and lower chains.
+std::vector<Vector2>
+compute2DConvexHullMonotoneChain(Containers::ArrayView<const Vector2> points);
+
+// Chan's algorithm: monotone chain hulls of groups of m points, gift wrapped
+// together using binary searched tangents, with m squared until it covers h.
+std::vector<Vector2>
+compute2DConvexHullChan(Containers::ArrayView<const Vector2> points);
+
+// Splits the points into one chunk per thread, hulls the chunks concurrently
+// with the monotone chain and merges the chunk hulls. A thread count of 0
+// uses one thread per hardware thread.
+std::vector<Vector2>
+compute2DConvexHullParallel(Containers::ArrayView<const Vector2> points,
+                            unsigned threadCount = 0);
+
+// Hull of points that arrive in chunks, for inputs larger than memory. Only
+// the running hull and the points added since the last merge are kept, and
+// once chunkSize points are pending they are hulled together with the
+// running hull. Memory stays within a small multiple of chunkSize plus the
+// hull size, however many points are added.
+//
+// hull() returns the polyline compute2DConvexHullJarvisMarch() would for all
+// the points.
+class StreamingConvexHull2D {
+  public:
+    explicit StreamingConvexHull2D(std::size_t chunkSize = 1 << 20);
+
+    void add(const Vector2& point);
+    void add(Containers::ArrayView<const Vector2> points);
+
+    // Points added so far.
+    std::size_t pointCount() const { return pointCount_; }
+
+    // Merges the pending points and returns the closed hull polyline, or
+    // the points themselves if only three or fewer were added.
+    std::vector<Vector2> hull();
+
+  private:
+    void merge();
+
+    std::size_t chunkSize_;
+    std::size_t pointCount_ = 0;
+    std::size_t hullSize_ = 0;
+    // Counter clockwise running hull, then the pending points.
+    std::vector<Vector2> points_;
+};
+
+// Hull of a point file (see core/GeometryFile.h) read chunkSize points at a
+// time with StreamingConvexHull2D, without mapping or loading it. A path of
+// "-" reads standard input. NullOpt with a message on Error output if the
+// file can't be read.
+Containers::Optional<std::vector<Vector2>>
+computeConvexHull2DStreaming(const std::string& path,
+                             std::size_t chunkSize = 1 << 20);
+
+} // namespace CompGeom
+
+#endif
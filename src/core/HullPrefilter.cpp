@@ -0,0 +1,179 @@
+#include "core/HullPrefilter.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace CompGeom {
+
+namespace {
+
+// Edge of the filter polygon as the line ex*y - ey*x + c = 0, with the
+// interior on the positive side, and the margin a point has to clear to be
+// considered strictly inside despite rounding.
+struct FilterEdge {
+    float ex, ey, c, margin;
+};
+
+// Extreme points in counter clockwise order of their directions, starting
+// with -x. Consecutive duplicates are dropped.
+std::vector<Vector2> extremePolygon(Containers::ArrayView<const Vector2> points,
+                                    HullPrefilter directions) {
+    // Indices into points: min x, min x+y, min y, max x-y, max x, max x+y,
+    // max y, min x-y.
+    std::size_t e[8] = {};
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        const float x = points[i].x(), y = points[i].y();
+        if (x < points[e[0]].x())
+            e[0] = i;
+        if (y < points[e[2]].y())
+            e[2] = i;
+        if (x > points[e[4]].x())
+            e[4] = i;
+        if (y > points[e[6]].y())
+            e[6] = i;
+        if (directions == HullPrefilter::EightDirections) {
+            if (x + y < points[e[1]].x() + points[e[1]].y())
+                e[1] = i;
+            if (x - y > points[e[3]].x() - points[e[3]].y())
+                e[3] = i;
+            if (x + y > points[e[5]].x() + points[e[5]].y())
+                e[5] = i;
+            if (x - y < points[e[7]].x() - points[e[7]].y())
+                e[7] = i;
+        }
+    }
+
+    const int step = directions == HullPrefilter::EightDirections ? 1 : 2;
+    std::vector<Vector2> polygon;
+    for (int d = 0; d < 8; d += step) {
+        const Vector2& p = points[e[d]];
+        if (polygon.empty() || (polygon.back() != p && polygon.front() != p))
+            polygon.push_back(p);
+    }
+    return polygon;
+}
+
+std::vector<FilterEdge> filterEdges(const std::vector<Vector2>& polygon,
+                                    float maxCoordinate) {
+    std::vector<FilterEdge> edges;
+    for (std::size_t i = 0; i < polygon.size(); ++i) {
+        const Vector2& a = polygon[i];
+        const Vector2& b = polygon[(i + 1) % polygon.size()];
+        const float ex = b.x() - a.x(), ey = b.y() - a.y();
+        // Covers the error of the rewritten cross product and of the
+        // rounded edge direction.
+        const float margin = 32.0f * FLT_EPSILON *
+                             (std::abs(ex) + std::abs(ey)) * maxCoordinate;
+        edges.push_back({ex, ey, ey * a.x() - ex * a.y(), margin});
+    }
+    return edges;
+}
+
+bool insideScalar(const std::vector<FilterEdge>& edges, const Vector2& p) {
+    for (const FilterEdge& e : edges) {
+        if (!(e.ex * p.y() - e.ey * p.x() + e.c > e.margin))
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::size_t aklToussaintPrefilter(Containers::ArrayView<const Vector2> points,
+                                  std::vector<Vector2>& kept,
+                                  HullPrefilter directions) {
+    kept.clear();
+    if (directions == HullPrefilter::None || points.size() <= 3) {
+        kept.assign(points.begin(), points.end());
+        return 0;
+    }
+
+    const std::vector<Vector2> polygon = extremePolygon(points, directions);
+    // Degenerate polygon, nothing is strictly inside.
+    if (polygon.size() < 3) {
+        kept.assign(points.begin(), points.end());
+        return 0;
+    }
+
+    float maxCoordinate = 0.0f;
+    for (const Vector2& p : polygon)
+        maxCoordinate = std::max(
+            maxCoordinate, std::max(std::abs(p.x()), std::abs(p.y())));
+    const std::vector<FilterEdge> edges = filterEdges(polygon, maxCoordinate);
+
+    const std::size_t n = points.size();
+    std::size_t i = 0;
+    // Vector2 is two tightly packed floats, so the input can be loaded as
+    // interleaved x, y pairs.
+    const float* data = points.data()->data();
+
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v0 = _mm256_loadu_ps(data + 2 * i);
+        const __m256 v1 = _mm256_loadu_ps(data + 2 * i + 8);
+        // Deinterleave, the shuffle works per 128 bit lane so fix up the
+        // order of the 64 bit chunks afterwards.
+        const __m256 xs = _mm256_castpd_ps(_mm256_permute4x64_pd(
+            _mm256_castps_pd(_mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0))),
+            _MM_SHUFFLE(3, 1, 2, 0)));
+        const __m256 ys = _mm256_castpd_ps(_mm256_permute4x64_pd(
+            _mm256_castps_pd(_mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1))),
+            _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const FilterEdge& e : edges) {
+            const __m256 cross = _mm256_add_ps(
+                _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(e.ex), ys),
+                              _mm256_mul_ps(_mm256_set1_ps(e.ey), xs)),
+                _mm256_set1_ps(e.c));
+            inside = _mm256_and_ps(
+                inside,
+                _mm256_cmp_ps(cross, _mm256_set1_ps(e.margin), _CMP_GT_OQ));
+        }
+        const int mask = _mm256_movemask_ps(inside);
+        if (mask == 0xff)
+            continue;
+        for (int lane = 0; lane < 8; ++lane) {
+            if (!(mask & (1 << lane)))
+                kept.push_back(points[i + lane]);
+        }
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+        const __m128 v0 = _mm_loadu_ps(data + 2 * i);
+        const __m128 v1 = _mm_loadu_ps(data + 2 * i + 4);
+        const __m128 xs = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 ys = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const FilterEdge& e : edges) {
+            const __m128 cross =
+                _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(e.ex), ys),
+                                      _mm_mul_ps(_mm_set1_ps(e.ey), xs)),
+                           _mm_set1_ps(e.c));
+            inside = _mm_and_ps(inside,
+                                _mm_cmpgt_ps(cross, _mm_set1_ps(e.margin)));
+        }
+        const int mask = _mm_movemask_ps(inside);
+        if (mask == 0xf)
+            continue;
+        for (int lane = 0; lane < 4; ++lane) {
+            if (!(mask & (1 << lane)))
+                kept.push_back(points[i + lane]);
+        }
+    }
+#endif
+
+    // Scalar fallback and the tail of the vector loops.
+    for (; i < n; ++i) {
+        if (!insideScalar(edges, points[i]))
+            kept.push_back(points[i]);
+    }
+
+    return n - kept.size();
+}
+
+} // namespace CompGeom
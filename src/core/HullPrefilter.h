@@ -0,0 +1,37 @@
+#ifndef COMP_GEOM_CORE_HULLPREFILTER_H
+#define COMP_GEOM_CORE_HULLPREFILTER_H
+
+#include <cstddef>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Number of directions the Akl-Toussaint prefilter finds extreme points in.
+enum class HullPrefilter {
+    None = 0,
+    FourDirections = 4,  // +-x, +-y.
+    EightDirections = 8  // +-x, +-y and the diagonals.
+};
+
+// Akl-Toussaint heuristic. Finds the extreme points in the given directions
+// and copies every point that is not strictly inside the polygon they span
+// into kept, preserving order. Returns the number of points removed. Points
+// within rounding distance of the polygon are always kept, so the convex hull
+// of kept is the hull of points.
+//
+// The inside test is vectorized with AVX2 (8 points at a time) or SSE2 (4
+// points) when the build enables them, otherwise a scalar loop is used.
+std::size_t aklToussaintPrefilter(
+    Containers::ArrayView<const Vector2> points, std::vector<Vector2>& kept,
+    HullPrefilter directions = HullPrefilter::EightDirections);
+
+} // namespace CompGeom
+
+#endif
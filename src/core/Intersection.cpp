@@ -0,0 +1,306 @@
+#include "core/Intersection.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "core/BentleyOttmann.h"
+#include "core/Parallel.h"
+#include "core/SegmentBatch.h"
+#include "core/SegmentGrid.h"
+#include "core/SegmentTable.h"
+
+namespace CompGeom {
+
+namespace {
+
+// Collects candidate pairs into a batch and tests them together once it is
+// full.
+class PairTester {
+  public:
+    PairTester() { batch_.reserve(BatchSize); }
+
+    void add(Containers::ArrayView<const Seg2> segs, int a, int b,
+             std::vector<SegmentIntersection>& result) {
+        batch_.add(segs[a], segs[b]);
+        pairs_.emplace_back(a, b);
+        if (batch_.size() == BatchSize)
+            flush(result);
+    }
+
+    void flush(std::vector<SegmentIntersection>& result) {
+        hitPairs_.clear();
+        hits_.clear();
+        intersectBatch(batch_, hitPairs_, hits_);
+        for (std::size_t k = 0; k < hits_.size(); ++k) {
+            const std::pair<int, int>& pair = pairs_[hitPairs_[k]];
+            result.push_back({pair.first, pair.second, hits_[k].point});
+        }
+        batch_.clear();
+        pairs_.clear();
+    }
+
+  private:
+    static constexpr std::size_t BatchSize = 4096;
+
+    SegmentPairBatch batch_;
+    std::vector<std::pair<int, int>> pairs_;
+    std::vector<std::size_t> hitPairs_;
+    std::vector<Seg2Intersection> hits_;
+};
+
+bool pairLess(const SegmentIntersection& lhs, const SegmentIntersection& rhs) {
+    return lhs.a < rhs.a || (lhs.a == rhs.a && lhs.b < rhs.b);
+}
+
+} // namespace
+
+std::vector<SegmentIntersection>
+findAllSegmentIntersections(Containers::ArrayView<const Seg2> segs) {
+    std::vector<SegmentIntersection> result;
+    sweepSegmentIntersections(segs,
+                              [&](int a, int b, const Vector2& point) {
+                                  result.push_back({a, b, point});
+                                  return true;
+                              });
+    return result;
+}
+
+std::size_t countSegmentIntersections(Containers::ArrayView<const Seg2> segs) {
+    std::size_t count = 0;
+    sweepSegmentIntersections(segs, [&](int, int, const Vector2&) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+bool anySegmentIntersection(Containers::ArrayView<const Seg2> segs) {
+    bool found = false;
+    sweepSegmentIntersections(segs, [&](int, int, const Vector2&) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+void forEachSegmentIntersection(Containers::ArrayView<const Seg2> segs,
+                                const IntersectionCallback& sink) {
+    sweepSegmentIntersections(segs, sink);
+}
+
+std::size_t countRedBlueIntersections(Containers::ArrayView<const Seg2> red,
+                                      Containers::ArrayView<const Seg2> blue,
+                                      bool layersSelfIntersect) {
+    std::size_t count = 0;
+    sweepRedBlueIntersections(red, blue,
+                              [&](int, int, const Vector2&) {
+                                  ++count;
+                                  return true;
+                              },
+                              layersSelfIntersect);
+    return count;
+}
+
+bool anyRedBlueIntersection(Containers::ArrayView<const Seg2> red,
+                            Containers::ArrayView<const Seg2> blue,
+                            bool layersSelfIntersect) {
+    bool found = false;
+    sweepRedBlueIntersections(red, blue,
+                              [&](int, int, const Vector2&) {
+                                  found = true;
+                                  return false;
+                              },
+                              layersSelfIntersect);
+    return found;
+}
+
+std::vector<RedBlueIntersection>
+findRedBlueIntersections(Containers::ArrayView<const Seg2> red,
+                         Containers::ArrayView<const Seg2> blue,
+                         bool layersSelfIntersect) {
+    std::vector<RedBlueIntersection> result;
+    sweepRedBlueIntersections(
+        red, blue,
+        [&](int r, int b, const Vector2& point) {
+            result.push_back({r, b, point});
+            return true;
+        },
+        layersSelfIntersect);
+    return result;
+}
+
+std::vector<SegmentIntersection>
+findAllSegmentIntersectionsParallel(Containers::ArrayView<const Seg2> segs,
+                                    unsigned threadCount) {
+    const unsigned threads = resolveThreadCount(threadCount);
+    if (threads <= 1 || segs.size() < 2)
+        return findAllSegmentIntersections(segs);
+
+    // Slab boundaries at quantiles of the endpoint x coordinates, so every
+    // slab has about the same number of endpoint events. Twice as many
+    // slabs as threads evens out slabs that are heavier in crossings.
+    std::vector<double> xs;
+    xs.reserve(2 * segs.size());
+    for (const Seg2& s : segs) {
+        xs.push_back(s.p.x());
+        xs.push_back(s.q.x());
+    }
+    std::sort(xs.begin(), xs.end());
+    const std::size_t slabCount = 2 * std::size_t(threads);
+    std::vector<double> bounds;
+    for (std::size_t k = 0; k <= slabCount; ++k) {
+        const double x = xs[std::min(k * xs.size() / slabCount, xs.size() - 1)];
+        if (bounds.empty() || x > bounds.back())
+            bounds.push_back(x);
+    }
+    if (bounds.size() < 2)
+        return findAllSegmentIntersections(segs);
+    bounds.back() = xs.back();
+
+    // Segments go to every slab they touch, found by binary search on the
+    // boundaries in one pass, renumbered in input order so the reported
+    // a < b still hold after mapping back. Slabs are half open except the
+    // last, so a segment starting at a boundary only belongs right of it.
+    const std::size_t slabs = bounds.size() - 1;
+    std::vector<std::vector<int>> members(slabs);
+    for (int i = 0; i < int(segs.size()); ++i) {
+        const double left = std::min(segs[i].p.x(), segs[i].q.x());
+        const double right = std::max(segs[i].p.x(), segs[i].q.x());
+        const std::size_t first = std::min<std::size_t>(
+            std::upper_bound(bounds.begin() + 1, bounds.end(), left) -
+                (bounds.begin() + 1),
+            slabs - 1);
+        const std::size_t last =
+            std::upper_bound(bounds.begin(), bounds.end() - 1, right) -
+            bounds.begin() - 1;
+        for (std::size_t k = first; k <= last; ++k)
+            members[k].push_back(i);
+    }
+
+    // Event points are exact, so every intersection is inside exactly one
+    // slab and reported once.
+    std::vector<std::vector<SegmentIntersection>> results(slabs);
+    parallelFor(slabs, threads, [&](std::size_t k, unsigned) {
+        SweepSlab slab;
+        slab.begin = bounds[k];
+        slab.end = bounds[k + 1];
+        slab.closed = k + 1 == slabs;
+        const std::vector<int>& original = members[k];
+        std::vector<Seg2> slabSegs;
+        slabSegs.reserve(original.size());
+        for (int i : original)
+            slabSegs.push_back(segs[i]);
+        std::vector<SegmentIntersection>& result = results[k];
+        sweepSegmentIntersections(
+            slabSegs,
+            [&](int a, int b, const Vector2& point) {
+                result.push_back({original[a], original[b], point});
+                return true;
+            },
+            SweepStatus::ArenaSet, slab);
+    });
+
+    std::vector<SegmentIntersection> merged;
+    for (const std::vector<SegmentIntersection>& result : results)
+        merged.insert(merged.end(), result.begin(), result.end());
+    std::sort(merged.begin(), merged.end(), pairLess);
+    return merged;
+}
+
+std::vector<SegmentIntersection>
+findSegmentIntersectionsBruteForce(Containers::ArrayView<const Seg2> segs) {
+    const SegmentTable table{segs};
+    PairTester tester;
+    std::vector<SegmentIntersection> result;
+    for (int i = 0; i < int(segs.size()); ++i) {
+        for (int j = i + 1; j < int(segs.size()); ++j) {
+            if (table.boxesOverlap(i, j))
+                tester.add(segs, i, j, result);
+        }
+    }
+    tester.flush(result);
+    return result;
+}
+
+std::vector<SegmentIntersection>
+findSegmentIntersectionsGrid(Containers::ArrayView<const Seg2> segs,
+                             unsigned threadCount, double cellSize) {
+    const SegmentTable table{segs};
+    const SegmentGrid grid{table, cellSize};
+
+    // Rows of cells are handed out to the threads, each collecting into its
+    // own tester and results.
+    const unsigned threads = resolveThreadCount(threadCount);
+    std::vector<PairTester> testers(threads);
+    std::vector<std::vector<SegmentIntersection>> results(threads);
+    parallelFor(std::size_t(grid.rows()), threads,
+                [&](std::size_t row, unsigned thread) {
+        PairTester& tester = testers[thread];
+        std::vector<SegmentIntersection>& result = results[thread];
+        const int r = int(row);
+        for (int c = 0; c < grid.columns(); ++c) {
+            const Containers::ArrayView<const int> cell = grid.cell(c, r);
+            for (std::size_t i = 0; i < cell.size(); ++i) {
+                for (std::size_t j = i + 1; j < cell.size(); ++j) {
+                    const int a = cell[i], b = cell[j];
+                    if (!table.boxesOverlap(a, b))
+                        continue;
+                    // Pairs sharing several cells are only tested in the
+                    // one with the lower left corner of the overlap of
+                    // their boxes.
+                    const double x = std::max(table.leftX()[a],
+                                              table.leftX()[b]);
+                    const double y = std::max(
+                        std::min(table.leftY()[a], table.rightY()[a]),
+                        std::min(table.leftY()[b], table.rightY()[b]));
+                    if (grid.column(x) == c && grid.row(y) == r)
+                        tester.add(segs, a, b, result);
+                }
+            }
+        }
+    });
+
+    std::vector<SegmentIntersection> merged;
+    for (unsigned t = 0; t < threads; ++t) {
+        testers[t].flush(results[t]);
+        merged.insert(merged.end(), results[t].begin(), results[t].end());
+    }
+    // Independent of how the rows got split between the threads.
+    std::sort(merged.begin(), merged.end(), pairLess);
+    return merged;
+}
+
+std::vector<Vector2>
+findIntersectingSegmentsSweep(Containers::ArrayView<const Seg2> segs) {
+    // Bentley-Ottmann, see core/BentleyOttmann.h. Replaces the
+    // https://cp-algorithms.com/geometry/intersecting_segments.html sweep,
+    // which only detects whether any intersection exists.
+    std::vector<Vector2> resPoints;
+    sweepSegmentIntersections(segs, [&](int, int, const Vector2& point) {
+        resPoints.push_back(point);
+        return true;
+    });
+    return resPoints;
+}
+
+std::vector<Vector2>
+findIntersectingSegmentsSweepParallel(Containers::ArrayView<const Seg2> segs,
+                                      unsigned threadCount) {
+    std::vector<Vector2> resPoints;
+    for (const SegmentIntersection& i :
+         findAllSegmentIntersectionsParallel(segs, threadCount))
+        resPoints.push_back(i.point);
+    return resPoints;
+}
+
+std::vector<Vector2>
+findIntersectingSegmentsGrid(Containers::ArrayView<const Seg2> segs,
+                             unsigned threadCount) {
+    std::vector<Vector2> resPoints;
+    for (const SegmentIntersection& i :
+         findSegmentIntersectionsGrid(segs, threadCount))
+        resPoints.push_back(i.point);
+    return resPoints;
+}
+
+} // namespace CompGeom
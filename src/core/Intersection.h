@@ -0,0 +1,113 @@
+#ifndef COMP_GEOM_CORE_INTERSECTION_H
+#define COMP_GEOM_CORE_INTERSECTION_H
+
+#include <cstddef>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/BentleyOttmann.h"
+#include "core/Seg2.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// A pair of intersecting input segments, a < b.
+struct SegmentIntersection {
+    int a;
+    int b;
+    Vector2 point;
+};
+
+// An intersecting pair of a red and a blue segment, indexing their inputs.
+struct RedBlueIntersection {
+    int red;
+    int blue;
+    Vector2 point;
+};
+
+// Every intersecting pair, found with the Bentley-Ottmann sweep in
+// O((n + k) log n).
+std::vector<SegmentIntersection>
+findAllSegmentIntersections(Containers::ArrayView<const Seg2> segs);
+
+// Output policies over the same sweep that never collect the pairs.
+
+// Number of intersecting pairs.
+std::size_t countSegmentIntersections(Containers::ArrayView<const Seg2> segs);
+
+// Whether any two segments intersect. The sweep stops at the first
+// intersection it finds.
+bool anySegmentIntersection(Containers::ArrayView<const Seg2> segs);
+
+// Passes every intersecting pair to sink as the sweep finds them, in sweep
+// order. Returning false from sink stops the sweep.
+void forEachSegmentIntersection(Containers::ArrayView<const Seg2> segs,
+                                const IntersectionCallback& sink);
+
+// Red-blue counterparts of the above, see findRedBlueIntersections().
+std::size_t countRedBlueIntersections(Containers::ArrayView<const Seg2> red,
+                                      Containers::ArrayView<const Seg2> blue,
+                                      bool layersSelfIntersect = true);
+bool anyRedBlueIntersection(Containers::ArrayView<const Seg2> red,
+                            Containers::ArrayView<const Seg2> blue,
+                            bool layersSelfIntersect = true);
+
+// Every intersecting pair of a red and a blue segment, skipping pairs within
+// a layer, see sweepRedBlueIntersections(). Layers known to be free of
+// crossings within themselves, like a planar road network against parcel
+// boundaries, should pass layersSelfIntersect false to skip sweeping them.
+std::vector<RedBlueIntersection>
+findRedBlueIntersections(Containers::ArrayView<const Seg2> red,
+                         Containers::ArrayView<const Seg2> blue,
+                         bool layersSelfIntersect = true);
+
+// Every intersecting pair, from independent Bentley-Ottmann sweeps over
+// vertical slabs holding about the same number of segment endpoints, run on
+// threadCount threads (0 meaning one per hardware thread). Segments crossing
+// a slab boundary take part in every slab they touch and each slab reports
+// the intersections inside it, ones on a boundary in the slab right of it.
+// Sorted by a, then b.
+std::vector<SegmentIntersection>
+findAllSegmentIntersectionsParallel(Containers::ArrayView<const Seg2> segs,
+                                    unsigned threadCount = 0);
+
+// Every intersecting pair, testing all of them in O(n^2). Reference for the
+// faster backends.
+std::vector<SegmentIntersection>
+findSegmentIntersectionsBruteForce(Containers::ArrayView<const Seg2> segs);
+
+// Every intersecting pair, testing only pairs that share a cell of a uniform
+// grid (see core/SegmentGrid.h). Much faster than the sweep for short,
+// evenly spread segments. Rows of cells are processed on threadCount threads
+// (0 meaning one per hardware thread). A pair sharing several cells is only
+// tested in the one holding the lower left corner of the overlap of the
+// bounding boxes, so it is reported once. A cellSize of zero or less is
+// picked from the segments. Sorted by a, then b.
+std::vector<SegmentIntersection>
+findSegmentIntersectionsGrid(Containers::ArrayView<const Seg2> segs,
+                             unsigned threadCount = 0, double cellSize = 0.0);
+
+// Sweep line over the segments, returning one intersection point per
+// intersecting pair.
+std::vector<Vector2>
+findIntersectingSegmentsSweep(Containers::ArrayView<const Seg2> segs);
+
+// Multi-threaded findIntersectingSegmentsSweep(), see
+// findAllSegmentIntersectionsParallel().
+std::vector<Vector2>
+findIntersectingSegmentsSweepParallel(Containers::ArrayView<const Seg2> segs,
+                                      unsigned threadCount = 0);
+
+// Same output as findIntersectingSegmentsSweep(), from the uniform grid
+// backend.
+std::vector<Vector2>
+findIntersectingSegmentsGrid(Containers::ArrayView<const Seg2> segs,
+                             unsigned threadCount = 0);
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,243 @@
+#include "core/KdTree.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <Magnum/Math/Functions.h>
+
+#include "core/Parallel.h"
+
+namespace CompGeom {
+
+namespace {
+
+// Ranges this small are scanned instead of split further.
+constexpr std::size_t LeafSize = 8;
+
+// Queries handed to a thread at a time.
+constexpr std::size_t QueryBlock = 256;
+
+// Puts the median of order[begin, end) by the depth's coordinate in the
+// middle and recurses into both halves.
+void build(Containers::ArrayView<const Vector2> points,
+           std::vector<std::uint32_t>& order, std::size_t begin,
+           std::size_t end, int depth) {
+    while (end - begin > LeafSize) {
+        const std::size_t mid = begin + (end - begin) / 2;
+        const int axis = depth & 1;
+        std::nth_element(order.begin() + begin, order.begin() + mid,
+                         order.begin() + end,
+                         [&](std::uint32_t a, std::uint32_t b) {
+                             return points[a][axis] < points[b][axis];
+                         });
+        build(points, order, begin, mid, depth + 1);
+        begin = mid + 1;
+        ++depth;
+    }
+}
+
+// The k closest points offered so far, closest first.
+class Nearest {
+  public:
+    Nearest(std::vector<std::pair<float, std::uint32_t>>& best, std::size_t k)
+        : best_(best), k_(k) {
+        best_.clear();
+    }
+
+    // Squared distance a point has to beat to get in.
+    float bound() const {
+        return best_.size() < k_ ? std::numeric_limits<float>::infinity()
+                                 : best_.back().first;
+    }
+
+    void offer(float distance, std::uint32_t index) {
+        if (k_ == 0 || (best_.size() == k_ && distance >= best_.back().first))
+            return;
+        if (best_.size() == k_)
+            best_.pop_back();
+        const std::pair<float, std::uint32_t> entry{distance, index};
+        best_.insert(std::upper_bound(best_.begin(), best_.end(), entry),
+                     entry);
+    }
+
+  private:
+    std::vector<std::pair<float, std::uint32_t>>& best_;
+    std::size_t k_;
+};
+
+} // namespace
+
+KdTree2D::KdTree2D(Containers::ArrayView<const Vector2> points,
+                   unsigned threadCount)
+    : indices_(points.size()) {
+    for (std::size_t i = 0; i != points.size(); ++i)
+        indices_[i] = std::uint32_t(i);
+
+    // Split the top levels here until there are a few subtrees per thread,
+    // then build those concurrently.
+    const std::size_t tasks = 4 * std::size_t(resolveThreadCount(threadCount));
+    struct Range {
+        std::size_t begin, end;
+        int depth;
+    };
+    std::vector<Range> ranges{{0, points.size(), 0}};
+    while (ranges.size() < tasks) {
+        std::vector<Range> split;
+        for (const Range& r : ranges) {
+            if (r.end - r.begin <= LeafSize)
+                continue;
+            const std::size_t mid = r.begin + (r.end - r.begin) / 2;
+            const int axis = r.depth & 1;
+            std::nth_element(indices_.begin() + r.begin,
+                             indices_.begin() + mid, indices_.begin() + r.end,
+                             [&](std::uint32_t a, std::uint32_t b) {
+                                 return points[a][axis] < points[b][axis];
+                             });
+            split.push_back({r.begin, mid, r.depth + 1});
+            split.push_back({mid + 1, r.end, r.depth + 1});
+        }
+        if (split.empty())
+            break;
+        ranges = std::move(split);
+    }
+    parallelFor(ranges.size(), threadCount, [&](std::size_t i, unsigned) {
+        build(points, indices_, ranges[i].begin, ranges[i].end,
+              ranges[i].depth);
+    });
+
+    points_.resize(points.size());
+    for (std::size_t i = 0; i != points.size(); ++i)
+        points_[i] = points[indices_[i]];
+}
+
+// Calls visit(distance, position) for the points of [begin, end) closer
+// than the square root of bound, which visit may shrink as it goes. The
+// near half is searched first so the bound is tight for the far one.
+template <class F>
+void KdTree2D::search(std::size_t begin, std::size_t end, int depth,
+                      const Vector2& query, float& bound, F&& visit) const {
+    while (end - begin > LeafSize) {
+        const std::size_t mid = begin + (end - begin) / 2;
+        const float distance = (points_[mid] - query).dot();
+        if (distance <= bound)
+            visit(distance, mid);
+        const float offset = query[depth & 1] - points_[mid][depth & 1];
+        ++depth;
+        if (offset < 0.0f) {
+            search(begin, mid, depth, query, bound, visit);
+            if (offset * offset > bound)
+                return;
+            begin = mid + 1;
+        } else {
+            search(mid + 1, end, depth, query, bound, visit);
+            if (offset * offset > bound)
+                return;
+            end = mid;
+        }
+    }
+    for (std::size_t i = begin; i != end; ++i) {
+        const float distance = (points_[i] - query).dot();
+        if (distance <= bound)
+            visit(distance, i);
+    }
+}
+
+std::uint32_t KdTree2D::nearest(const Vector2& query) const {
+    float bound = std::numeric_limits<float>::infinity();
+    std::uint32_t best = KdTreeNoPoint;
+    search(0, points_.size(), 0, query, bound,
+           [&](float distance, std::size_t i) {
+               if (best != KdTreeNoPoint && distance == bound)
+                   return;
+               bound = distance;
+               best = indices_[i];
+           });
+    return best;
+}
+
+void KdTree2D::nearest(const Vector2& query, std::size_t k,
+                       std::vector<std::uint32_t>& out) const {
+    out.clear();
+    if (k == 0)
+        return;
+    // Reused across the queries of a batch.
+    thread_local std::vector<std::pair<float, std::uint32_t>> best;
+    Nearest nearest{best, k};
+    float bound = nearest.bound();
+    search(0, points_.size(), 0, query, bound,
+           [&](float distance, std::size_t i) {
+               nearest.offer(distance, indices_[i]);
+               bound = nearest.bound();
+           });
+    for (const auto& entry : best)
+        out.push_back(entry.second);
+}
+
+void KdTree2D::withinRadius(const Vector2& query, float radius,
+                            std::vector<std::uint32_t>& out) const {
+    float bound = radius * radius;
+    search(0, points_.size(), 0, query, bound,
+           [&](float, std::size_t i) { out.push_back(indices_[i]); });
+}
+
+std::vector<std::uint32_t>
+findNearestNeighbours(const KdTree2D& tree,
+                      Containers::ArrayView<const Vector2> queries,
+                      std::size_t k, unsigned threadCount) {
+    std::vector<std::uint32_t> out(queries.size() * k, KdTreeNoPoint);
+    const std::size_t blocks = (queries.size() + QueryBlock - 1) / QueryBlock;
+    parallelFor(blocks, threadCount, [&](std::size_t block, unsigned) {
+        std::vector<std::uint32_t> found;
+        const std::size_t end =
+            std::min(queries.size(), (block + 1) * QueryBlock);
+        for (std::size_t q = block * QueryBlock; q != end; ++q) {
+            tree.nearest(queries[q], k, found);
+            std::copy(found.begin(), found.end(), out.begin() + q * k);
+        }
+    });
+    return out;
+}
+
+RadiusQueryResults
+findPointsWithinRadius(const KdTree2D& tree,
+                       Containers::ArrayView<const Vector2> queries,
+                       float radius, unsigned threadCount) {
+    RadiusQueryResults out;
+    out.offsets.assign(queries.size() + 1, 0);
+    const std::size_t blocks = (queries.size() + QueryBlock - 1) / QueryBlock;
+    std::vector<std::vector<std::uint32_t>> found(blocks);
+    parallelFor(blocks, threadCount, [&](std::size_t block, unsigned) {
+        const std::size_t end =
+            std::min(queries.size(), (block + 1) * QueryBlock);
+        for (std::size_t q = block * QueryBlock; q != end; ++q) {
+            const std::size_t before = found[block].size();
+            tree.withinRadius(queries[q], radius, found[block]);
+            out.offsets[q + 1] = found[block].size() - before;
+        }
+    });
+    for (std::size_t q = 0; q != queries.size(); ++q)
+        out.offsets[q + 1] += out.offsets[q];
+    out.indices.reserve(out.offsets.back());
+    for (const std::vector<std::uint32_t>& block : found)
+        out.indices.insert(out.indices.end(), block.begin(), block.end());
+    return out;
+}
+
+std::vector<std::uint32_t>
+findNearestNeighboursBruteForce(Containers::ArrayView<const Vector2> points,
+                                Containers::ArrayView<const Vector2> queries,
+                                std::size_t k) {
+    std::vector<std::uint32_t> out(queries.size() * k, KdTreeNoPoint);
+    std::vector<std::pair<float, std::uint32_t>> best;
+    for (std::size_t q = 0; q != queries.size(); ++q) {
+        Nearest nearest{best, k};
+        for (std::size_t i = 0; i != points.size(); ++i)
+            nearest.offer((points[i] - queries[q]).dot(), std::uint32_t(i));
+        for (std::size_t i = 0; i != best.size(); ++i)
+            out[q * k + i] = best[i].second;
+    }
+    return out;
+}
+
+} // namespace CompGeom
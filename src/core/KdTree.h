@@ -0,0 +1,87 @@
+#ifndef COMP_GEOM_CORE_KDTREE_H
+#define COMP_GEOM_CORE_KDTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Padding of a k nearest result when there are fewer than k points.
+constexpr std::uint32_t KdTreeNoPoint = 0xffffffffu;
+
+// Static 2D k-d tree with an implicit layout: the points are reordered so
+// the median of every range [begin, end) sits at its middle, splitting on x
+// at even depths and y at odd ones. Child ranges follow from the indices,
+// so the tree is just the reordered points and their input indices.
+class KdTree2D {
+  public:
+    // Builds in O(n log n) with median selection. Below the top levels the
+    // subtrees are independent and built on threadCount threads (0 meaning
+    // one per hardware thread). At most 2^32 - 2 points.
+    explicit KdTree2D(Containers::ArrayView<const Vector2> points,
+                      unsigned threadCount = 0);
+
+    std::size_t size() const { return points_.size(); }
+
+    // Input index of the closest point, KdTreeNoPoint if the tree is empty.
+    // Ties go to any of the closest.
+    std::uint32_t nearest(const Vector2& query) const;
+
+    // Replaces out with the input indices of the k closest points, closest
+    // first.
+    void nearest(const Vector2& query, std::size_t k,
+                 std::vector<std::uint32_t>& out) const;
+
+    // Appends the input indices of the points at most radius away, in no
+    // particular order.
+    void withinRadius(const Vector2& query, float radius,
+                      std::vector<std::uint32_t>& out) const;
+
+  private:
+    template <class F>
+    void search(std::size_t begin, std::size_t end, int depth,
+                const Vector2& query, float& bound, F&& visit) const;
+
+    std::vector<Vector2> points_;
+    std::vector<std::uint32_t> indices_;
+};
+
+// Answers of a batch of radius queries, packed: the points within the
+// radius of query i are indices[offsets[i]] up to indices[offsets[i + 1]].
+struct RadiusQueryResults {
+    std::vector<std::size_t> offsets;
+    std::vector<std::uint32_t> indices;
+};
+
+// The k nearest points of every query, k entries per query, closest first
+// and padded with KdTreeNoPoint. Blocks of queries run on threadCount
+// threads (0 meaning one per hardware thread).
+std::vector<std::uint32_t>
+findNearestNeighbours(const KdTree2D& tree,
+                      Containers::ArrayView<const Vector2> queries,
+                      std::size_t k = 1, unsigned threadCount = 0);
+
+// The points within radius of every query, on threadCount threads.
+RadiusQueryResults
+findPointsWithinRadius(const KdTree2D& tree,
+                       Containers::ArrayView<const Vector2> queries,
+                       float radius, unsigned threadCount = 0);
+
+// Same output as findNearestNeighbours() by comparing every query with
+// every point, as a reference.
+std::vector<std::uint32_t>
+findNearestNeighboursBruteForce(Containers::ArrayView<const Vector2> points,
+                                Containers::ArrayView<const Vector2> queries,
+                                std::size_t k = 1);
+
+} // namespace CompGeom
+
+#endif
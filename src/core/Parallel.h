@@ -0,0 +1,49 @@
+#ifndef COMP_GEOM_CORE_PARALLEL_H
+#define COMP_GEOM_CORE_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace CompGeom {
+
+// Thread count to use for a requested count, 0 meaning one per hardware
+// thread.
+inline unsigned resolveThreadCount(unsigned threadCount) {
+    if (threadCount != 0)
+        return threadCount;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Calls fn(i, thread) for every i in [0, count) on up to threadCount threads
+// (the calling thread being one of them). Work items are handed out one at a
+// time so uneven items still balance.
+template <class F>
+void parallelFor(std::size_t count, unsigned threadCount, F&& fn) {
+    const unsigned threads = unsigned(
+        std::min<std::size_t>(resolveThreadCount(threadCount), count));
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < count; ++i)
+            fn(i, 0u);
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&](unsigned thread) {
+        for (std::size_t i = next++; i < count; i = next++)
+            fn(i, thread);
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& t : pool)
+        t.join();
+}
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,572 @@
+#include "core/Predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace CompGeom {
+
+namespace {
+
+// Half an ulp of one, the unit roundoff of double arithmetic.
+constexpr double Epsilon = std::numeric_limits<double>::epsilon() / 2.0;
+// Shewchuk's bound for the two product, one subtraction determinant.
+constexpr double CcwErrorBound = Orient2dErrorBound;
+// Shewchuk's bound for the lifted three by three incircle determinant.
+constexpr double IncircleErrorBound = (10.0 + 96.0 * Epsilon) * Epsilon;
+
+int sign(double value) { return (value > 0.0) - (value < 0.0); }
+
+// a + b = x + y exactly.
+void twoSum(double a, double b, double& x, double& y) {
+    x = a + b;
+    const double bVirtual = x - a;
+    const double aVirtual = x - bVirtual;
+    y = (a - aVirtual) + (b - bVirtual);
+}
+
+// a - b = x + y exactly.
+void twoDiff(double a, double b, double& x, double& y) {
+    x = a - b;
+    const double bVirtual = a - x;
+    const double aVirtual = x + bVirtual;
+    y = (a - aVirtual) + (bVirtual - b);
+}
+
+// a * b = x + y exactly.
+void twoProduct(double a, double b, double& x, double& y) {
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+// Sum of doubles kept exactly as a nonoverlapping expansion. Grow-Expansion
+// with zero elimination keeps the components ordered by magnitude, so the
+// sign of the sum is the sign of the last component. Each added double
+// grows it by at most one component, which bounds the capacity needed.
+template <int Capacity> class Expansion {
+  public:
+    void add(double b) {
+        double q = b;
+        int m = 0;
+        for (int i = 0; i < size_; ++i) {
+            double h;
+            twoSum(q, components_[i], q, h);
+            if (h != 0.0)
+                components_[m++] = h;
+        }
+        components_[m++] = q;
+        size_ = m;
+    }
+
+    void addProduct(double a, double b) {
+        double x, y;
+        twoProduct(a, b, x, y);
+        add(x);
+        add(y);
+    }
+
+    void addProduct(double a, double b, double c) {
+        double x, y;
+        twoProduct(a, b, x, y);
+        addProduct(x, c);
+        addProduct(y, c);
+    }
+
+    void addProduct(double a, double b, double c, double d) {
+        double x, y;
+        twoProduct(a, b, x, y);
+        addProduct(x, c, d);
+        addProduct(y, c, d);
+    }
+
+    double approximate() const {
+        for (int i = size_; i > 0; --i) {
+            if (components_[i - 1] != 0.0)
+                return components_[i - 1];
+        }
+        return 0.0;
+    }
+
+  private:
+    double components_[Capacity];
+    int size_ = 0;
+};
+
+// Enough for the 16 three term products of compareSegmentHeights().
+typedef Expansion<72> SmallExpansion;
+
+// Enough for the 12 four term products of incircle() with every factor
+// split in two, 12 * 16 * 8 components.
+typedef Expansion<1536> LargeExpansion;
+
+// A double with a bound on how far it is from the value it stands for. The
+// rounding error of each operation is computed exactly, so results of exact
+// operations on exact inputs stay exact.
+struct Filtered {
+    double value;
+    double error;
+
+    Filtered(double value = 0.0, double error = 0.0)
+        : value(value), error(error) {}
+};
+
+Filtered operator+(const Filtered& a, const Filtered& b) {
+    double x, y;
+    twoSum(a.value, b.value, x, y);
+    return {x, a.error + b.error + std::abs(y)};
+}
+
+Filtered operator-(const Filtered& a, const Filtered& b) {
+    double x, y;
+    twoDiff(a.value, b.value, x, y);
+    return {x, a.error + b.error + std::abs(y)};
+}
+
+Filtered operator*(const Filtered& a, const Filtered& b) {
+    double x, y;
+    twoProduct(a.value, b.value, x, y);
+    return {x, std::abs(a.value) * b.error + std::abs(b.value) * a.error +
+                   a.error * b.error + std::abs(y)};
+}
+
+// Whether the sign of the value is known despite the error. The margin
+// covers the rounding of the error bound itself.
+bool signKnown(const Filtered& f) {
+    return f.error == 0.0 ||
+           std::abs(f.value) > f.error * (1.0 + 1024.0 * Epsilon);
+}
+
+// An exact value as a nonoverlapping expansion of any length, for the
+// rare fallbacks of predicates too deep for a fixed Expansion. Short ones,
+// the common case, stay on the stack.
+class ExactNumber {
+  public:
+    ExactNumber(double value = 0.0) {
+        if (value != 0.0)
+            inline_[size_++] = value;
+    }
+
+    friend ExactNumber operator+(ExactNumber a, const ExactNumber& b) {
+        for (std::size_t i = 0; i != b.size_; ++i)
+            a.add(b.data()[i]);
+        return a;
+    }
+
+    friend ExactNumber operator-(ExactNumber a, const ExactNumber& b) {
+        for (std::size_t i = 0; i != b.size_; ++i)
+            a.add(-b.data()[i]);
+        return a;
+    }
+
+    friend ExactNumber operator*(const ExactNumber& a, const ExactNumber& b) {
+        ExactNumber out;
+        for (std::size_t i = 0; i != a.size_; ++i) {
+            for (std::size_t j = 0; j != b.size_; ++j) {
+                double x, y;
+                twoProduct(a.data()[i], b.data()[j], x, y);
+                out.add(y);
+                out.add(x);
+            }
+        }
+        return out;
+    }
+
+    int sign() const {
+        return size_ == 0 ? 0 : CompGeom::sign(data()[size_ - 1]);
+    }
+
+  private:
+    static constexpr std::size_t InlineCapacity = 16;
+
+    double* data() { return heap_.empty() ? inline_ : heap_.data(); }
+    const double* data() const {
+        return heap_.empty() ? inline_ : heap_.data();
+    }
+
+    // Grow-Expansion with zero elimination, as in Expansion::add().
+    void add(double b) {
+        if (b == 0.0)
+            return;
+        if (size_ == (heap_.empty() ? InlineCapacity : heap_.size())) {
+            std::vector<double> grown(2 * size_);
+            std::copy(data(), data() + size_, grown.begin());
+            heap_.swap(grown);
+        }
+        double* components = data();
+        double q = b;
+        std::size_t m = 0;
+        for (std::size_t i = 0; i < size_; ++i) {
+            double h;
+            twoSum(q, components[i], q, h);
+            if (h != 0.0)
+                components[m++] = h;
+        }
+        if (q != 0.0)
+            components[m++] = q;
+        size_ = m;
+    }
+
+    double inline_[InlineCapacity];
+    // Storage once the expansion outgrows inline_, all of it in use or not.
+    std::vector<double> heap_;
+    std::size_t size_ = 0;
+};
+
+// Sign of an expression given as a generic lambda called with a zero of
+// the number type to evaluate it in, filtered first and exact if needed.
+template <class Expression> int exactSign(const Expression& expression) {
+    const Filtered filtered = expression(Filtered{});
+    if (signKnown(filtered))
+        return sign(filtered.value);
+    return expression(ExactNumber{}).sign();
+}
+
+} // namespace
+
+// Homogeneous coordinates of an exact point, x / w and y / w with w > 0. A
+// crossing is a0 + (a1 - a0) t with t = cross(b0 - a0, s) / cross(r, s),
+// r and s the directions of the lines.
+struct ExactPointAccess {
+    template <class Number> struct Homogeneous {
+        Number x, y, w;
+    };
+
+    template <class Number>
+    static Homogeneous<Number> homogeneous(const ExactPoint& p) {
+        return compute<Number>(p);
+    }
+
+    static bool isCrossing(const ExactPoint& p) { return p.crossing_; }
+
+    static bool sameLines(const ExactPoint& p, const ExactPoint& q) {
+        if (!p.crossing_ || !q.crossing_)
+            return false;
+        for (int i = 0; i != 4; ++i) {
+            if (p.lines_[i] != q.lines_[i])
+                return false;
+        }
+        return true;
+    }
+
+    template <class Number>
+    static Homogeneous<Number> compute(const ExactPoint& p) {
+        if (!p.crossing_)
+            return {Number(p.approximate_.x()), Number(p.approximate_.y()),
+                    Number(1.0)};
+        const Vector2d* l = p.lines_;
+        const Number a0x(l[0].x()), a0y(l[0].y());
+        const Number rx = Number(l[1].x()) - a0x;
+        const Number ry = Number(l[1].y()) - a0y;
+        const Number sx = Number(l[3].x()) - Number(l[2].x());
+        const Number sy = Number(l[3].y()) - Number(l[2].y());
+        const Number d = rx * sy - ry * sx;
+        const Number t = (Number(l[2].x()) - a0x) * sy -
+                         (Number(l[2].y()) - a0y) * sx;
+        return {a0x * d + t * rx, a0y * d + t * ry, d};
+    }
+};
+
+template <>
+ExactPointAccess::Homogeneous<Filtered>
+ExactPointAccess::homogeneous<Filtered>(const ExactPoint& p) {
+    return {{p.homogeneous_[0], p.homogeneousError_[0]},
+            {p.homogeneous_[1], p.homogeneousError_[1]},
+            {p.homogeneous_[2], p.homogeneousError_[2]}};
+}
+
+namespace {
+
+template <class Number>
+ExactPointAccess::Homogeneous<Number> homogeneous(const ExactPoint& p) {
+    return ExactPointAccess::homogeneous<Number>(p);
+}
+
+} // namespace
+
+ExactPoint::ExactPoint(const Vector2d& point)
+    : approximate_(point), error_(0.0, 0.0),
+      homogeneous_{point.x(), point.y(), 1.0}, homogeneousError_{} {}
+
+ExactPoint::ExactPoint(const Vector2d& a0, const Vector2d& a1,
+                       const Vector2d& b0, const Vector2d& b1)
+    : lines_{a0, a1, b0, b1}, crossing_(true) {
+    // Lines sharing an endpoint cross there.
+    for (const Vector2d& a : {a0, a1}) {
+        if (a == b0 || a == b1) {
+            *this = ExactPoint{a};
+            return;
+        }
+    }
+    if (crossSign(a0, a1, b0, b1) < 0) {
+        std::swap(lines_[0], lines_[2]);
+        std::swap(lines_[1], lines_[3]);
+    }
+    // x / w off by at most (ex + |x / w| ew) / (|w| - ew), plus the
+    // rounding of the division.
+    const auto h = ExactPointAccess::compute<Filtered>(*this);
+    homogeneous_[0] = h.x.value;
+    homogeneous_[1] = h.y.value;
+    homogeneous_[2] = h.w.value;
+    homogeneousError_[0] = h.x.error;
+    homogeneousError_[1] = h.y.error;
+    homogeneousError_[2] = h.w.error;
+    const double w = std::abs(h.w.value);
+    approximate_ = {h.x.value / h.w.value, h.y.value / h.w.value};
+    if (h.w.error >= w) {
+        const double infinity = std::numeric_limits<double>::infinity();
+        error_ = {infinity, infinity};
+        return;
+    }
+    const double margin = 1.0 + 16.0 * Epsilon;
+    error_ = {((h.x.error + std::abs(approximate_.x()) * h.w.error) /
+                   (w - h.w.error) +
+               Epsilon * std::abs(approximate_.x())) *
+                  margin,
+              ((h.y.error + std::abs(approximate_.y()) * h.w.error) /
+                   (w - h.w.error) +
+               Epsilon * std::abs(approximate_.y())) *
+                  margin};
+
+    // A vertical or horizontal line fixes a coordinate exactly, which
+    // spares the exact fallback when comparing it with the line's own.
+    for (int i : {0, 2}) {
+        if (lines_[i].x() == lines_[i + 1].x()) {
+            approximate_.x() = lines_[i].x();
+            error_.x() = 0.0;
+        }
+        if (lines_[i].y() == lines_[i + 1].y()) {
+            approximate_.y() = lines_[i].y();
+            error_.y() = 0.0;
+        }
+    }
+}
+
+namespace Implementation {
+
+int compareXExact(const ExactPoint& p, const ExactPoint& q) {
+    // Crossings of the same two lines, a pair queued again.
+    if (ExactPointAccess::sameLines(p, q))
+        return 0;
+    return exactSign([&](auto zero) {
+        using Number = decltype(zero);
+        const auto hp = homogeneous<Number>(p), hq = homogeneous<Number>(q);
+        return hp.x * hq.w - hq.x * hp.w;
+    });
+}
+
+int compareYExact(const ExactPoint& p, const ExactPoint& q) {
+    if (ExactPointAccess::sameLines(p, q))
+        return 0;
+    return exactSign([&](auto zero) {
+        using Number = decltype(zero);
+        const auto hp = homogeneous<Number>(p), hq = homogeneous<Number>(q);
+        return hp.y * hq.w - hq.y * hp.w;
+    });
+}
+
+int compareXExact(const ExactPoint& p, double x) {
+    if (std::isinf(x))
+        return x > 0.0 ? -1 : 1;
+    return exactSign([&](auto zero) {
+        using Number = decltype(zero);
+        const auto h = homogeneous<Number>(p);
+        return h.x - Number(x) * h.w;
+    });
+}
+
+int compareYExact(const ExactPoint& p, double y) {
+    if (std::isinf(y))
+        return y > 0.0 ? -1 : 1;
+    return exactSign([&](auto zero) {
+        using Number = decltype(zero);
+        const auto h = homogeneous<Number>(p);
+        return h.y - Number(y) * h.w;
+    });
+}
+
+} // namespace Implementation
+
+int compareLineHeight(const Vector2d& l0, const Vector2d& l1,
+                      const ExactPoint& p) {
+    // The height at x / w is l0.y + (x / w - l0.x) dy / dx, scaled by the
+    // positive w dx.
+    return exactSign([&](auto zero) {
+        using Number = decltype(zero);
+        const auto h = homogeneous<Number>(p);
+        const Number dx = Number(l1.x()) - Number(l0.x());
+        const Number dy = Number(l1.y()) - Number(l0.y());
+        return Number(l0.y()) * h.w * dx +
+               (h.x - Number(l0.x()) * h.w) * dy - h.y * dx;
+    });
+}
+
+int compareLineHeight(const Vector2d& l0, const Vector2d& l1,
+                      const ExactPoint& p, double y) {
+    return exactSign([&](auto zero) {
+        using Number = decltype(zero);
+        const auto h = homogeneous<Number>(p);
+        const Number dx = Number(l1.x()) - Number(l0.x());
+        const Number dy = Number(l1.y()) - Number(l0.y());
+        return (Number(l0.y()) - Number(y)) * h.w * dx +
+               (h.x - Number(l0.x()) * h.w) * dy;
+    });
+}
+
+int compareSegmentHeights(const Vector2d& a0, const Vector2d& a1,
+                          const Vector2d& b0, const Vector2d& b1,
+                          const ExactPoint& p) {
+    if (!ExactPointAccess::isCrossing(p))
+        return compareSegmentHeights(a0, a1, b0, b1, p.approximate().x());
+    return exactSign([&](auto zero) {
+        using Number = decltype(zero);
+        const auto h = homogeneous<Number>(p);
+        const Number dxa = Number(a1.x()) - Number(a0.x());
+        const Number dya = Number(a1.y()) - Number(a0.y());
+        const Number dxb = Number(b1.x()) - Number(b0.x());
+        const Number dyb = Number(b1.y()) - Number(b0.y());
+        const Number heightA = Number(a0.y()) * h.w * dxa +
+                               (h.x - Number(a0.x()) * h.w) * dya;
+        const Number heightB = Number(b0.y()) * h.w * dxb +
+                               (h.x - Number(b0.x()) * h.w) * dyb;
+        return heightA * dxb - heightB * dxa;
+    });
+}
+
+double orient2d(const Vector2d& a, const Vector2d& b, const Vector2d& c) {
+    const double detLeft = (a.x() - c.x()) * (b.y() - c.y());
+    const double detRight = (a.y() - c.y()) * (b.x() - c.x());
+    const double det = detLeft - detRight;
+    const double errorBound =
+        CcwErrorBound * (std::abs(detLeft) + std::abs(detRight));
+    if (std::abs(det) > errorBound)
+        return det;
+
+    // ax by - ax cy - cx by - ay bx + ay cx + cy bx, the cx cy terms cancel.
+    SmallExpansion e;
+    e.addProduct(a.x(), b.y());
+    e.addProduct(-a.x(), c.y());
+    e.addProduct(-c.x(), b.y());
+    e.addProduct(-a.y(), b.x());
+    e.addProduct(a.y(), c.x());
+    e.addProduct(c.y(), b.x());
+    return e.approximate();
+}
+
+double incircle(const Vector2d& a, const Vector2d& b, const Vector2d& c,
+                const Vector2d& d) {
+    const double adx = a.x() - d.x(), ady = a.y() - d.y();
+    const double bdx = b.x() - d.x(), bdy = b.y() - d.y();
+    const double cdx = c.x() - d.x(), cdy = c.y() - d.y();
+    const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    const double cdxady = cdx * ady, adxcdy = adx * cdy;
+    const double adxbdy = adx * bdy, bdxady = bdx * ady;
+    const double alift = adx * adx + ady * ady;
+    const double blift = bdx * bdx + bdy * bdy;
+    const double clift = cdx * cdx + cdy * cdy;
+    const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) +
+                       clift * (adxbdy - bdxady);
+    const double permanent =
+        (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+        (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+        (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    if (std::abs(det) > IncircleErrorBound * permanent)
+        return det;
+
+    // Split each difference exactly into two doubles and sum every term of
+    // the expanded determinant, alift (bdx cdy - cdx bdy) and so on.
+    double ax[2], ay[2], bx[2], by[2], cx[2], cy[2];
+    twoDiff(a.x(), d.x(), ax[0], ax[1]);
+    twoDiff(a.y(), d.y(), ay[0], ay[1]);
+    twoDiff(b.x(), d.x(), bx[0], bx[1]);
+    twoDiff(b.y(), d.y(), by[0], by[1]);
+    twoDiff(c.x(), d.x(), cx[0], cx[1]);
+    twoDiff(c.y(), d.y(), cy[0], cy[1]);
+    // Lifted coordinate times the two products of one minor, with signs.
+    const struct {
+        const double* lift;
+        const double* p0;
+        const double* p1;
+        const double* q0;
+        const double* q1;
+    } minors[] = {{ax, bx, cy, cx, by}, {ay, bx, cy, cx, by},
+                  {bx, cx, ay, ax, cy}, {by, cx, ay, ax, cy},
+                  {cx, ax, by, bx, ay}, {cy, ax, by, bx, ay}};
+    LargeExpansion e;
+    for (const auto& m : minors) {
+        for (int i = 0; i != 16; ++i) {
+            const double l0 = m.lift[i & 1], l1 = m.lift[(i >> 1) & 1];
+            const int f0 = (i >> 2) & 1, f1 = (i >> 3) & 1;
+            if (l0 == 0.0 || l1 == 0.0)
+                continue;
+            if (m.p0[f0] != 0.0 && m.p1[f1] != 0.0)
+                e.addProduct(l0, l1, m.p0[f0], m.p1[f1]);
+            if (m.q0[f0] != 0.0 && m.q1[f1] != 0.0)
+                e.addProduct(-l0, l1, m.q0[f0], m.q1[f1]);
+        }
+    }
+    return e.approximate();
+}
+
+int crossSign(const Vector2d& a0, const Vector2d& a1, const Vector2d& b0,
+              const Vector2d& b1) {
+    const double left = (a1.x() - a0.x()) * (b1.y() - b0.y());
+    const double right = (a1.y() - a0.y()) * (b1.x() - b0.x());
+    const double cross = left - right;
+    if (std::abs(cross) > CcwErrorBound * (std::abs(left) + std::abs(right)))
+        return sign(cross);
+
+    SmallExpansion e;
+    e.addProduct(a1.x(), b1.y());
+    e.addProduct(-a1.x(), b0.y());
+    e.addProduct(-a0.x(), b1.y());
+    e.addProduct(a0.x(), b0.y());
+    e.addProduct(-a1.y(), b1.x());
+    e.addProduct(a1.y(), b0.x());
+    e.addProduct(a0.y(), b1.x());
+    e.addProduct(-a0.y(), b0.x());
+    return sign(e.approximate());
+}
+
+int compareSegmentHeights(const Vector2d& a0, const Vector2d& a1,
+                          const Vector2d& b0, const Vector2d& b1, double x) {
+    // The height of a at x is na/da with na = a0.y a1.x - a1.y a0.x +
+    // x (a1.y - a0.y) and da = a1.x - a0.x > 0, so compare na db with nb da.
+    const double na = (a0.y() * a1.x() - a1.y() * a0.x()) +
+                      x * (a1.y() - a0.y());
+    const double nb = (b0.y() * b1.x() - b1.y() * b0.x()) +
+                      x * (b1.y() - b0.y());
+    const double da = a1.x() - a0.x();
+    const double db = b1.x() - b0.x();
+    const double det = na * db - nb * da;
+    const double permanentA = std::abs(a0.y() * a1.x()) +
+                              std::abs(a1.y() * a0.x()) +
+                              std::abs(x) * (std::abs(a1.y()) + std::abs(a0.y()));
+    const double permanentB = std::abs(b0.y() * b1.x()) +
+                              std::abs(b1.y() * b0.x()) +
+                              std::abs(x) * (std::abs(b1.y()) + std::abs(b0.y()));
+    const double errorBound =
+        16.0 * Epsilon *
+        (permanentA * std::abs(db) + permanentB * std::abs(da));
+    if (std::abs(det) > errorBound)
+        return sign(det);
+
+    // Expand both products into the sixteen three term products.
+    const double aTerms[4][2] = {
+        {a0.y(), a1.x()}, {-a1.y(), a0.x()}, {x, a1.y()}, {-x, a0.y()}};
+    const double bTerms[4][2] = {
+        {b0.y(), b1.x()}, {-b1.y(), b0.x()}, {x, b1.y()}, {-x, b0.y()}};
+    SmallExpansion e;
+    for (const auto& t : aTerms) {
+        e.addProduct(t[0], t[1], b1.x());
+        e.addProduct(t[0], t[1], -b0.x());
+    }
+    for (const auto& t : bTerms) {
+        e.addProduct(-t[0], t[1], a1.x());
+        e.addProduct(-t[0], t[1], -a0.x());
+    }
+    return sign(e.approximate());
+}
+
+} // namespace CompGeom
@@ -0,0 +1,164 @@
+#ifndef COMP_GEOM_CORE_PREDICATES_H
+#define COMP_GEOM_CORE_PREDICATES_H
+
+#include <limits>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Geometric predicates with exact signs. Each first evaluates in double with
+// an error bound (a few multiplies on top of the plain formula) and only
+// when the bound can't decide the sign recomputes it exactly with floating
+// point expansions, after Shewchuk's "Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates". Inputs are assumed not
+// to overflow or underflow when multiplied, which always holds for float
+// coordinates.
+
+// Bound on the error of the plain double evaluation of orient2d(), relative
+// to the sum of the magnitudes of its two products. Vectorized filters use it
+// to tell which signs they can trust without the exact fallback.
+constexpr double Orient2dErrorBound =
+    (3.0 + 8.0 * std::numeric_limits<double>::epsilon()) *
+    std::numeric_limits<double>::epsilon() / 2.0;
+
+// Positive if c is left of the directed line a -> b, negative if right and
+// zero if the points are collinear. Only the sign is exact.
+double orient2d(const Vector2d& a, const Vector2d& b, const Vector2d& c);
+
+inline double orient2d(const Vector2& a, const Vector2& b, const Vector2& c) {
+    return orient2d(Vector2d{a}, Vector2d{b}, Vector2d{c});
+}
+
+// Positive if d is inside the circle through a, b and c, given
+// counterclockwise, negative if outside and zero if the four points are
+// cocircular. Only the sign is exact.
+double incircle(const Vector2d& a, const Vector2d& b, const Vector2d& c,
+                const Vector2d& d);
+
+inline double incircle(const Vector2& a, const Vector2& b, const Vector2& c,
+                       const Vector2& d) {
+    return incircle(Vector2d{a}, Vector2d{b}, Vector2d{c}, Vector2d{d});
+}
+
+// Sign of Math::cross(a1 - a0, b1 - b0), e.g. for comparing directions.
+int crossSign(const Vector2d& a0, const Vector2d& a1, const Vector2d& b0,
+              const Vector2d& b1);
+
+// Sign of the height of the line through a0, a1 minus the height of the
+// line through b0, b1 at x. Both lines must be given left to right with
+// a0.x() < a1.x() and b0.x() < b1.x().
+int compareSegmentHeights(const Vector2d& a0, const Vector2d& a1,
+                          const Vector2d& b0, const Vector2d& b1, double x);
+
+// A point that is either given or the crossing of two non-parallel lines,
+// kept as the lines so comparisons with it are exact. Computed crossings
+// round to the nearest double differently for each pair of lines through
+// the same point, these don't.
+class ExactPoint {
+  public:
+    explicit ExactPoint(const Vector2d& point = Vector2d{});
+
+    // Crossing of the line through a0, a1 with the line through b0, b1,
+    // which must not be parallel.
+    ExactPoint(const Vector2d& a0, const Vector2d& a1, const Vector2d& b0,
+               const Vector2d& b1);
+
+    bool isCrossing() const { return crossing_; }
+
+    // The point rounded to double, exact unless it is a crossing.
+    const Vector2d& approximate() const { return approximate_; }
+
+    // Bound on how far each coordinate of approximate() is off.
+    const Vector2d& error() const { return error_; }
+
+  private:
+    friend struct ExactPointAccess;
+
+    // a0, a1, b0, b1, ordered so the cross product of the directions is
+    // positive.
+    Vector2d lines_[4];
+    Vector2d approximate_;
+    Vector2d error_;
+    // Homogeneous coordinates x, y, w in double and bounds on their error,
+    // the first step of every comparison.
+    double homogeneous_[3];
+    double homogeneousError_[3];
+    bool crossing_ = false;
+};
+
+namespace Implementation {
+
+// Sign of a - b from rounded values and bounds on their error, or 2 if
+// those can't tell.
+inline int compareApproximate(double a, double aError, double b,
+                              double bError) {
+    const double diff = a - b;
+    const double error = (aError + bError) *
+                         (1.0 + 4.0 * std::numeric_limits<double>::epsilon());
+    if (error == 0.0 || Math::abs(diff) > error)
+        return int(diff > 0.0) - int(diff < 0.0);
+    return 2;
+}
+
+int compareXExact(const ExactPoint& p, const ExactPoint& q);
+int compareYExact(const ExactPoint& p, const ExactPoint& q);
+int compareXExact(const ExactPoint& p, double x);
+int compareYExact(const ExactPoint& p, double y);
+
+} // namespace Implementation
+
+// Sign of the x coordinate of p minus the one of q, exact. The rounded
+// coordinates decide all but close calls.
+inline int compareX(const ExactPoint& p, const ExactPoint& q) {
+    const int approximate = Implementation::compareApproximate(
+        p.approximate().x(), p.error().x(), q.approximate().x(),
+        q.error().x());
+    return approximate != 2 ? approximate
+                            : Implementation::compareXExact(p, q);
+}
+
+// Sign of the y coordinate of p minus the one of q, exact.
+inline int compareY(const ExactPoint& p, const ExactPoint& q) {
+    const int approximate = Implementation::compareApproximate(
+        p.approximate().y(), p.error().y(), q.approximate().y(),
+        q.error().y());
+    return approximate != 2 ? approximate
+                            : Implementation::compareYExact(p, q);
+}
+
+// Sign of the x coordinate of p minus x, exact. x may be infinite.
+inline int compareX(const ExactPoint& p, double x) {
+    const int approximate = Implementation::compareApproximate(
+        p.approximate().x(), p.error().x(), x, 0.0);
+    return approximate != 2 ? approximate
+                            : Implementation::compareXExact(p, x);
+}
+
+// Sign of the y coordinate of p minus y, exact. y may be infinite.
+inline int compareY(const ExactPoint& p, double y) {
+    const int approximate = Implementation::compareApproximate(
+        p.approximate().y(), p.error().y(), y, 0.0);
+    return approximate != 2 ? approximate
+                            : Implementation::compareYExact(p, y);
+}
+
+// Sign of the height of the line through l0, l1 at the x of p minus the
+// height of p, or minus y. The line must be given left to right.
+int compareLineHeight(const Vector2d& l0, const Vector2d& l1,
+                      const ExactPoint& p);
+int compareLineHeight(const Vector2d& l0, const Vector2d& l1,
+                      const ExactPoint& p, double y);
+
+// compareSegmentHeights() at the x of p.
+int compareSegmentHeights(const Vector2d& a0, const Vector2d& a1,
+                          const Vector2d& b0, const Vector2d& b1,
+                          const ExactPoint& p);
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef COMP_GEOM_CORE_SEG2_H
+#define COMP_GEOM_CORE_SEG2_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Predicates.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Where two segments meet, point = p + (q - p) * t and
+// point = other.p + (other.q - other.p) * u.
+struct Seg2Intersection {
+    Vector2 point;
+    float t;
+    float u;
+};
+
+class Seg2 {
+  public:
+    Vector2 p;
+    Vector2 q;
+    Seg2(Vector2 p, Vector2 q) : p(p), q(q){};
+
+    // Helper function which returns y position at x along segment.
+    float getY(float x) const {
+        // If vertical
+        if (p.x() == q.x())
+            return p.y();
+        // Normal case.
+        return p.y() + (q.y() - p.y()) * (x - p.x()) / (q.x() - p.x());
+    };
+
+    // Exact test and intersection point from one set of orientation tests.
+    // Touching and collinear overlapping segments intersect, the latter at
+    // the first point they share.
+    Containers::Optional<Seg2Intersection> intersect(const Seg2& other) const {
+        const double o1 = orient2d(p, q, other.p);
+        const double o2 = orient2d(p, q, other.q);
+        const double o3 = orient2d(other.p, other.q, p);
+        const double o4 = orient2d(other.p, other.q, q);
+        const int s1 = sign(o1), s2 = sign(o2), s3 = sign(o3), s4 = sign(o4);
+        // Proper crossing or an endpoint on the other segment.
+        if (!(s1 * s2 < 0 && s3 * s4 < 0) &&
+            !(s1 == 0 && inBox(p, q, other.p)) &&
+            !(s2 == 0 && inBox(p, q, other.q)) &&
+            !(s3 == 0 && inBox(other.p, other.q, p)) &&
+            !(s4 == 0 && inBox(other.p, other.q, q)))
+            return Containers::NullOpt;
+
+        if ((s1 == 0 && s2 == 0) || (s3 == 0 && s4 == 0)) {
+            const Vector2 point =
+                std::max(leftmost(p, q), leftmost(other.p, other.q), lexLess);
+            return Seg2Intersection{point, parameter(p, q, point),
+                                    parameter(other.p, other.q, point)};
+        }
+
+        // The orientations are linear along each segment, so they also give
+        // where it crosses the other's line. Zeros are exact, which keeps
+        // touching endpoints exact.
+        const double t = crossing(o3, o4), u = crossing(o1, o2);
+        Vector2 point;
+        if (t == 0.0 || t == 1.0)
+            point = t == 0.0 ? p : q;
+        else if (u == 0.0 || u == 1.0)
+            point = u == 0.0 ? other.p : other.q;
+        else
+            point = Vector2{Vector2d{p} + (Vector2d{q} - Vector2d{p}) * t};
+        return Seg2Intersection{point, float(t), float(u)};
+    }
+
+    bool doesIntersect(const Seg2& other) const {
+        return bool(intersect(other));
+    };
+
+    Vector2 intersection(const Seg2& other) const {
+        const Containers::Optional<Seg2Intersection> hit = intersect(other);
+        if (!hit)
+            return Vector2(std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::quiet_NaN());
+        return hit->point;
+    }
+
+    // Exact comparison of the heights at the start of the later segment.
+    friend bool operator<(const Seg2& lhs, const Seg2& rhs) {
+        float x = std::max(std::min(lhs.p.x(), lhs.q.x()),
+                           std::min(rhs.p.x(), rhs.q.x()));
+        return heightSign(lhs, rhs, x) < 0;
+    };
+
+  private:
+    static int sign(double value) { return (value > 0.0) - (value < 0.0); }
+
+    static bool lexLess(const Vector2& lhs, const Vector2& rhs) {
+        return lhs.x() < rhs.x() || (lhs.x() == rhs.x() && lhs.y() < rhs.y());
+    }
+
+    static Vector2 leftmost(const Vector2& a, const Vector2& b) {
+        return lexLess(b, a) ? b : a;
+    }
+
+    static Vector2 rightmost(const Vector2& a, const Vector2& b) {
+        return lexLess(b, a) ? a : b;
+    }
+
+    // Whether c is in the bounding box of a, b.
+    static bool inBox(const Vector2& a, const Vector2& b, const Vector2& c) {
+        return Math::min(a.x(), b.x()) <= c.x() &&
+               c.x() <= Math::max(a.x(), b.x()) &&
+               Math::min(a.y(), b.y()) <= c.y() &&
+               c.y() <= Math::max(a.y(), b.y());
+    }
+
+    // Where the orientation goes from start to end along a segment crosses
+    // zero.
+    static double crossing(double start, double end) {
+        if (start == 0.0)
+            return 0.0;
+        if (end == 0.0)
+            return 1.0;
+        return start / (start - end);
+    }
+
+    // Parameter of c, known to be on the segment a, b.
+    static float parameter(const Vector2& a, const Vector2& b,
+                           const Vector2& c) {
+        const Vector2 d = b - a;
+        const float length = Math::dot(d, d);
+        return length == 0.0f ? 0.0f : Math::dot(c - a, d) / length;
+    }
+
+    // Sign of lhs.getY(x) - rhs.getY(x), exactly.
+    static int heightSign(const Seg2& lhs, const Seg2& rhs, float x) {
+        const bool lhsVertical = lhs.p.x() == lhs.q.x();
+        const bool rhsVertical = rhs.p.x() == rhs.q.x();
+        if (lhsVertical && rhsVertical)
+            return sign(lhs.p.y() - rhs.p.y());
+        // A vertical segment is at the height of its first point.
+        if (lhsVertical)
+            return sign(orient2d(leftmost(rhs.p, rhs.q),
+                                 rightmost(rhs.p, rhs.q),
+                                 Vector2{x, lhs.p.y()}));
+        if (rhsVertical)
+            return -heightSign(rhs, lhs, x);
+        return compareSegmentHeights(Vector2d{leftmost(lhs.p, lhs.q)},
+                                     Vector2d{rightmost(lhs.p, lhs.q)},
+                                     Vector2d{leftmost(rhs.p, rhs.q)},
+                                     Vector2d{rightmost(rhs.p, rhs.q)}, x);
+    }
+};
+
+class Event {
+  public:
+    float x;
+    int type; // +1 == Start, -1 == End
+    int id;
+
+    Event(float x, float type, float id) : x(x), type(type), id(id){};
+
+    bool operator<(const Event& e) const {
+        if (x != e.x)
+            return x < e.x;   // Normal case
+        return type > e.type; // Vertical case - ensures correct ordering.
+    }
+};
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,195 @@
+#include "core/SegmentBatch.h"
+
+#include "core/Predicates.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace CompGeom {
+
+namespace {
+
+// Appends the proper crossing of pair i, given its four certain
+// orientations.
+void addCrossing(const SegmentPairBatch& batch, std::size_t i, double o1,
+                 double o2, double o3, double o4,
+                 std::vector<std::size_t>& hitPairs,
+                 std::vector<Seg2Intersection>& hits) {
+    const Seg2 a = batch.a(i);
+    const double t = o3 / (o3 - o4), u = o1 / (o1 - o2);
+    const Vector2 point{Vector2d{a.p} + (Vector2d{a.q} - Vector2d{a.p}) * t};
+    hitPairs.push_back(i);
+    hits.push_back({point, float(t), float(u)});
+}
+
+void addScalar(const SegmentPairBatch& batch, std::size_t i,
+               std::vector<std::size_t>& hitPairs,
+               std::vector<Seg2Intersection>& hits) {
+    const Containers::Optional<Seg2Intersection> hit =
+        batch.a(i).intersect(batch.b(i));
+    if (hit) {
+        hitPairs.push_back(i);
+        hits.push_back(*hit);
+    }
+}
+
+#if defined(__AVX2__)
+// orient2d() of four point triples at once, clearing the lanes of certain
+// whose sign the error bound can't vouch for.
+__m256d orient4(__m256d ax, __m256d ay, __m256d bx, __m256d by, __m256d cx,
+                __m256d cy, __m256d& certain) {
+    const __m256d detLeft =
+        _mm256_mul_pd(_mm256_sub_pd(ax, cx), _mm256_sub_pd(by, cy));
+    const __m256d detRight =
+        _mm256_mul_pd(_mm256_sub_pd(ay, cy), _mm256_sub_pd(bx, cx));
+    const __m256d det = _mm256_sub_pd(detLeft, detRight);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256d bound = _mm256_mul_pd(
+        _mm256_set1_pd(Orient2dErrorBound),
+        _mm256_add_pd(_mm256_andnot_pd(signBit, detLeft),
+                      _mm256_andnot_pd(signBit, detRight)));
+    certain = _mm256_and_pd(
+        certain,
+        _mm256_cmp_pd(_mm256_andnot_pd(signBit, det), bound, _CMP_GT_OQ));
+    return det;
+}
+#elif defined(__SSE2__)
+// orient2d() of two point triples at once, clearing the lanes of certain
+// whose sign the error bound can't vouch for.
+__m128d orient2(__m128d ax, __m128d ay, __m128d bx, __m128d by, __m128d cx,
+                __m128d cy, __m128d& certain) {
+    const __m128d detLeft = _mm_mul_pd(_mm_sub_pd(ax, cx), _mm_sub_pd(by, cy));
+    const __m128d detRight =
+        _mm_mul_pd(_mm_sub_pd(ay, cy), _mm_sub_pd(bx, cx));
+    const __m128d det = _mm_sub_pd(detLeft, detRight);
+    const __m128d signBit = _mm_set1_pd(-0.0);
+    const __m128d bound =
+        _mm_mul_pd(_mm_set1_pd(Orient2dErrorBound),
+                   _mm_add_pd(_mm_andnot_pd(signBit, detLeft),
+                              _mm_andnot_pd(signBit, detRight)));
+    certain = _mm_and_pd(
+        certain, _mm_cmpgt_pd(_mm_andnot_pd(signBit, det), bound));
+    return det;
+}
+#endif
+
+} // namespace
+
+void SegmentPairBatch::reserve(std::size_t count) {
+    for (std::vector<double>* v :
+         {&ax0_, &ay0_, &ax1_, &ay1_, &bx0_, &by0_, &bx1_, &by1_})
+        v->reserve(count);
+}
+
+void SegmentPairBatch::clear() {
+    for (std::vector<double>* v :
+         {&ax0_, &ay0_, &ax1_, &ay1_, &bx0_, &by0_, &bx1_, &by1_})
+        v->clear();
+}
+
+void SegmentPairBatch::add(const Seg2& a, const Seg2& b) {
+    ax0_.push_back(a.p.x());
+    ay0_.push_back(a.p.y());
+    ax1_.push_back(a.q.x());
+    ay1_.push_back(a.q.y());
+    bx0_.push_back(b.p.x());
+    by0_.push_back(b.p.y());
+    bx1_.push_back(b.q.x());
+    by1_.push_back(b.q.y());
+}
+
+Seg2 SegmentPairBatch::a(std::size_t i) const {
+    return Seg2(Vector2(float(ax0_[i]), float(ay0_[i])),
+                Vector2(float(ax1_[i]), float(ay1_[i])));
+}
+
+Seg2 SegmentPairBatch::b(std::size_t i) const {
+    return Seg2(Vector2(float(bx0_[i]), float(by0_[i])),
+                Vector2(float(bx1_[i]), float(by1_[i])));
+}
+
+std::size_t intersectBatch(const SegmentPairBatch& batch,
+                           std::vector<std::size_t>& hitPairs,
+                           std::vector<Seg2Intersection>& hits) {
+    const std::size_t before = hits.size();
+    const std::size_t n = batch.size();
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4) {
+        const __m256d ax0 = _mm256_loadu_pd(batch.ax0_.data() + i);
+        const __m256d ay0 = _mm256_loadu_pd(batch.ay0_.data() + i);
+        const __m256d ax1 = _mm256_loadu_pd(batch.ax1_.data() + i);
+        const __m256d ay1 = _mm256_loadu_pd(batch.ay1_.data() + i);
+        const __m256d bx0 = _mm256_loadu_pd(batch.bx0_.data() + i);
+        const __m256d by0 = _mm256_loadu_pd(batch.by0_.data() + i);
+        const __m256d bx1 = _mm256_loadu_pd(batch.bx1_.data() + i);
+        const __m256d by1 = _mm256_loadu_pd(batch.by1_.data() + i);
+        __m256d certain = _mm256_castsi256_pd(_mm256_set1_epi32(-1));
+        const __m256d o1 = orient4(ax0, ay0, ax1, ay1, bx0, by0, certain);
+        const __m256d o2 = orient4(ax0, ay0, ax1, ay1, bx1, by1, certain);
+        const __m256d o3 = orient4(bx0, by0, bx1, by1, ax0, ay0, certain);
+        const __m256d o4 = orient4(bx0, by0, bx1, by1, ax1, ay1, certain);
+        const int certainMask = _mm256_movemask_pd(certain);
+        // Opposite signs on both segments, read off the sign bits.
+        const int crossMask = _mm256_movemask_pd(
+            _mm256_and_pd(_mm256_xor_pd(o1, o2), _mm256_xor_pd(o3, o4)));
+        if (certainMask == 0xf && crossMask == 0)
+            continue;
+        double o[4][4];
+        _mm256_storeu_pd(o[0], o1);
+        _mm256_storeu_pd(o[1], o2);
+        _mm256_storeu_pd(o[2], o3);
+        _mm256_storeu_pd(o[3], o4);
+        for (int lane = 0; lane < 4; ++lane) {
+            if (!(certainMask & (1 << lane)))
+                addScalar(batch, i + lane, hitPairs, hits);
+            else if (crossMask & (1 << lane))
+                addCrossing(batch, i + lane, o[0][lane], o[1][lane],
+                            o[2][lane], o[3][lane], hitPairs, hits);
+        }
+    }
+#elif defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        const __m128d ax0 = _mm_loadu_pd(batch.ax0_.data() + i);
+        const __m128d ay0 = _mm_loadu_pd(batch.ay0_.data() + i);
+        const __m128d ax1 = _mm_loadu_pd(batch.ax1_.data() + i);
+        const __m128d ay1 = _mm_loadu_pd(batch.ay1_.data() + i);
+        const __m128d bx0 = _mm_loadu_pd(batch.bx0_.data() + i);
+        const __m128d by0 = _mm_loadu_pd(batch.by0_.data() + i);
+        const __m128d bx1 = _mm_loadu_pd(batch.bx1_.data() + i);
+        const __m128d by1 = _mm_loadu_pd(batch.by1_.data() + i);
+        __m128d certain = _mm_castsi128_pd(_mm_set1_epi32(-1));
+        const __m128d o1 = orient2(ax0, ay0, ax1, ay1, bx0, by0, certain);
+        const __m128d o2 = orient2(ax0, ay0, ax1, ay1, bx1, by1, certain);
+        const __m128d o3 = orient2(bx0, by0, bx1, by1, ax0, ay0, certain);
+        const __m128d o4 = orient2(bx0, by0, bx1, by1, ax1, ay1, certain);
+        const int certainMask = _mm_movemask_pd(certain);
+        const int crossMask = _mm_movemask_pd(
+            _mm_and_pd(_mm_xor_pd(o1, o2), _mm_xor_pd(o3, o4)));
+        if (certainMask == 0x3 && crossMask == 0)
+            continue;
+        double o[4][2];
+        _mm_storeu_pd(o[0], o1);
+        _mm_storeu_pd(o[1], o2);
+        _mm_storeu_pd(o[2], o3);
+        _mm_storeu_pd(o[3], o4);
+        for (int lane = 0; lane < 2; ++lane) {
+            if (!(certainMask & (1 << lane)))
+                addScalar(batch, i + lane, hitPairs, hits);
+            else if (crossMask & (1 << lane))
+                addCrossing(batch, i + lane, o[0][lane], o[1][lane],
+                            o[2][lane], o[3][lane], hitPairs, hits);
+        }
+    }
+#endif
+
+    // Scalar fallback and the tail of the vector loops.
+    for (; i < n; ++i)
+        addScalar(batch, i, hitPairs, hits);
+
+    return hits.size() - before;
+}
+
+} // namespace CompGeom
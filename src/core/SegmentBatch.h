@@ -0,0 +1,61 @@
+#ifndef COMP_GEOM_CORE_SEGMENTBATCH_H
+#define COMP_GEOM_CORE_SEGMENTBATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Seg2.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Candidate pairs of segments a, b kept in one contiguous array per
+// coordinate, so a whole run of pairs can be tested with vector
+// instructions. Coordinates are stored in double, which holds the float
+// input exactly.
+class SegmentPairBatch {
+  public:
+    std::size_t size() const { return ax0_.size(); }
+
+    void reserve(std::size_t count);
+    void clear();
+    void add(const Seg2& a, const Seg2& b);
+
+    // Pair i as segments again.
+    Seg2 a(std::size_t i) const;
+    Seg2 b(std::size_t i) const;
+
+  private:
+    friend std::size_t intersectBatch(const SegmentPairBatch& batch,
+                                      std::vector<std::size_t>& hitPairs,
+                                      std::vector<Seg2Intersection>& hits);
+
+    std::vector<double> ax0_, ay0_, ax1_, ay1_;
+    std::vector<double> bx0_, by0_, bx1_, by1_;
+};
+
+// Tests every pair of the batch with the same result as Seg2::intersect(),
+// appending the index and intersection of each intersecting pair to
+// hitPairs and hits. Returns the number of pairs appended.
+//
+// The four orientations of each pair are evaluated with AVX2 (4 pairs at a
+// time) or SSE2 (2 pairs) when the build enables them, together with their
+// error bounds. Pairs where every sign is certain are decided, and proper
+// crossings solved, right there; touching, collinear and near degenerate
+// pairs go through the exact scalar query.
+//
+// Only the brute force and grid backends have runs of independent pairs to
+// fill a batch with. The sweep tests at most two pairs of neighbours per
+// event and needs each answer before it knows the next pair, so it uses the
+// scalar SegmentTable::intersects() that the kernel falls back to, and
+// keeps crossings exact as an ExactPoint instead of solving them here.
+std::size_t intersectBatch(const SegmentPairBatch& batch,
+                           std::vector<std::size_t>& hitPairs,
+                           std::vector<Seg2Intersection>& hits);
+
+} // namespace CompGeom
+
+#endif
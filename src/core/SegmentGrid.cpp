@@ -0,0 +1,103 @@
+#include "core/SegmentGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace CompGeom {
+
+namespace {
+
+struct Bounds {
+    double minX, minY, maxX, maxY;
+};
+
+Bounds segmentBounds(const SegmentTable& table) {
+    Bounds b{0.0, 0.0, 0.0, 0.0};
+    for (std::size_t s = 0; s < table.size(); ++s) {
+        const double lowY = std::min(table.leftY()[s], table.rightY()[s]);
+        const double highY = std::max(table.leftY()[s], table.rightY()[s]);
+        if (s == 0) {
+            b = {table.leftX()[s], lowY, table.rightX()[s], highY};
+            continue;
+        }
+        b.minX = std::min(b.minX, table.leftX()[s]);
+        b.minY = std::min(b.minY, lowY);
+        b.maxX = std::max(b.maxX, table.rightX()[s]);
+        b.maxY = std::max(b.maxY, highY);
+    }
+    return b;
+}
+
+} // namespace
+
+double SegmentGrid::suggestCellSize(const SegmentTable& table) {
+    const std::size_t n = table.size();
+    if (n == 0)
+        return 1.0;
+    const Bounds b = segmentBounds(table);
+    const double width = b.maxX - b.minX, height = b.maxY - b.minY;
+
+    double extent = 0.0;
+    for (std::size_t s = 0; s < n; ++s)
+        extent += std::max(table.rightX()[s] - table.leftX()[s],
+                           std::abs(table.rightY()[s] - table.leftY()[s]));
+    extent /= double(n);
+
+    // At most about four cells per segment.
+    const double minimum =
+        width > 0.0 && height > 0.0
+            ? std::sqrt(width * height / (4.0 * double(n)))
+            : std::max(width, height) / (4.0 * double(n));
+    const double size = std::max(extent, minimum);
+    return size > 0.0 ? size : 1.0;
+}
+
+SegmentGrid::SegmentGrid(const SegmentTable& table, double cellSize) {
+    const std::size_t n = table.size();
+    const Bounds b = segmentBounds(table);
+    minX_ = b.minX;
+    minY_ = b.minY;
+    cellSize_ = cellSize > 0.0 ? cellSize : suggestCellSize(table);
+    // Too small a requested size would need more cells than memory, grow
+    // it until the grid is within a generous multiple of the input.
+    for (;;) {
+        const double columns = std::floor((b.maxX - b.minX) / cellSize_) + 1.0;
+        const double rows = std::floor((b.maxY - b.minY) / cellSize_) + 1.0;
+        if (columns * rows <= 64.0 * double(n + 16)) {
+            columns_ = int(columns);
+            rows_ = int(rows);
+            break;
+        }
+        cellSize_ *= 2.0;
+    }
+
+    // Count the segments per cell, then fill them in order.
+    offsets_.assign(std::size_t(columns_) * rows_ + 1, 0);
+    auto forEachCell = [&](int s, auto&& fn) {
+        const int c0 = column(table.leftX()[s]);
+        const int c1 = column(table.rightX()[s]);
+        const int r0 = row(std::min(table.leftY()[s], table.rightY()[s]));
+        const int r1 = row(std::max(table.leftY()[s], table.rightY()[s]));
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                fn(std::size_t(r) * columns_ + c);
+    };
+    for (int s = 0; s < int(n); ++s)
+        forEachCell(s, [&](std::size_t c) { ++offsets_[c + 1]; });
+    for (std::size_t c = 1; c < offsets_.size(); ++c)
+        offsets_[c] += offsets_[c - 1];
+    segments_.resize(offsets_.back());
+    std::vector<std::size_t> fill(offsets_.begin(), offsets_.end() - 1);
+    for (int s = 0; s < int(n); ++s)
+        forEachCell(s, [&](std::size_t c) { segments_[fill[c]++] = s; });
+}
+
+int SegmentGrid::column(double x) const {
+    return std::min(std::max(int((x - minX_) / cellSize_), 0), columns_ - 1);
+}
+
+int SegmentGrid::row(double y) const {
+    return std::min(std::max(int((y - minY_) / cellSize_), 0), rows_ - 1);
+}
+
+} // namespace CompGeom
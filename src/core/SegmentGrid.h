@@ -0,0 +1,52 @@
+#ifndef COMP_GEOM_CORE_SEGMENTGRID_H
+#define COMP_GEOM_CORE_SEGMENTGRID_H
+
+#include <cstddef>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+
+#include "core/SegmentTable.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Uniform grid over the bounding box of a set of segments, every cell
+// listing the segments whose bounding box touches it. The lists are packed
+// in one array, cell by cell in row major order.
+class SegmentGrid {
+  public:
+    // A cellSize of zero or less picks one with suggestCellSize().
+    explicit SegmentGrid(const SegmentTable& table, double cellSize = 0.0);
+
+    // Roughly the average extent of a segment, so most segments land in a
+    // few cells, but no smaller than needed to keep the cell count within
+    // a small multiple of the segment count.
+    static double suggestCellSize(const SegmentTable& table);
+
+    double cellSize() const { return cellSize_; }
+    int columns() const { return columns_; }
+    int rows() const { return rows_; }
+
+    // Cell coordinates of a point, clamped to the grid.
+    int column(double x) const;
+    int row(double y) const;
+
+    // Segments of the cell in ascending order.
+    Containers::ArrayView<const int> cell(int column, int row) const {
+        const std::size_t c = std::size_t(row) * columns_ + column;
+        return {segments_.data() + offsets_[c],
+                offsets_[c + 1] - offsets_[c]};
+    }
+
+  private:
+    double cellSize_, minX_, minY_;
+    int columns_, rows_;
+    std::vector<std::size_t> offsets_;
+    std::vector<int> segments_;
+};
+
+} // namespace CompGeom
+
+#endif
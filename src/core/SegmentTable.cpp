@@ -0,0 +1,69 @@
+#include "core/SegmentTable.h"
+
+#include <utility>
+
+#include "core/Predicates.h"
+
+namespace CompGeom {
+
+SegmentTable::SegmentTable(Containers::ArrayView<const Seg2> segs) {
+    const std::size_t n = segs.size();
+    leftX_.resize(n);
+    leftY_.resize(n);
+    rightX_.resize(n);
+    rightY_.resize(n);
+    slope_.resize(n);
+    intercept_.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        Vector2d l{segs[i].p}, r{segs[i].q};
+        if (r.x() < l.x() || (r.x() == l.x() && r.y() < l.y()))
+            std::swap(l, r);
+        leftX_[i] = l.x();
+        leftY_[i] = l.y();
+        rightX_[i] = r.x();
+        rightY_[i] = r.y();
+        if (l.x() == r.x()) {
+            slope_[i] = std::numeric_limits<double>::infinity();
+            intercept_[i] = 0.0;
+        } else {
+            slope_[i] = (r.y() - l.y()) / (r.x() - l.x());
+            intercept_[i] = l.y() - slope_[i] * l.x();
+        }
+    }
+}
+
+bool SegmentTable::intersects(int a, int b) const {
+    if (!boxesOverlap(a, b))
+        return false;
+
+    // Proper crossing, or an endpoint on the other segment.
+    const Vector2d la = left(a), ra = right(a), lb = left(b), rb = right(b);
+    const int o1 = sign(orient2d(la, ra, lb));
+    const int o2 = sign(orient2d(la, ra, rb));
+    const int o3 = sign(orient2d(lb, rb, la));
+    const int o4 = sign(orient2d(lb, rb, ra));
+    if (o1 * o2 < 0 && o3 * o4 < 0)
+        return true;
+    auto inBox = [](const Vector2d& l, const Vector2d& r, const Vector2d& c) {
+        return l.x() <= c.x() && c.x() <= r.x() &&
+               Math::min(l.y(), r.y()) <= c.y() &&
+               c.y() <= Math::max(l.y(), r.y());
+    };
+    return (o1 == 0 && inBox(la, ra, lb)) || (o2 == 0 && inBox(la, ra, rb)) ||
+           (o3 == 0 && inBox(lb, rb, la)) || (o4 == 0 && inBox(lb, rb, ra));
+}
+
+int SegmentTable::compareHeightsExact(int a, int b, double x) const {
+    return compareSegmentHeights(left(a), right(a), left(b), right(b), x);
+}
+
+int SegmentTable::compareHeightExact(int s, double x, double y) const {
+    // The point is left of the segment direction when it is above it.
+    return -sign(orient2d(left(s), right(s), Vector2d{x, y}));
+}
+
+int SegmentTable::compareSlopesExact(int a, int b) const {
+    return crossSign(left(b), right(b), left(a), right(a));
+}
+
+} // namespace CompGeom
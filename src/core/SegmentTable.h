@@ -0,0 +1,164 @@
+#ifndef COMP_GEOM_CORE_SEGMENTTABLE_H
+#define COMP_GEOM_CORE_SEGMENTTABLE_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/Predicates.h"
+#include "core/Seg2.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Segments preprocessed once for sweeps and pairwise tests, stored as a
+// structure of arrays. Endpoints are normalized so the left one is the
+// lexicographically smaller, in double so nothing of the float input is
+// lost. Non-vertical segments also keep the slope and intercept of their
+// line, which makes a height on the sweep line one multiply-add. The
+// comparisons use those as a filter and fall back to the exact predicates
+// only when the rounding error could flip the sign.
+class SegmentTable {
+  public:
+    explicit SegmentTable(Containers::ArrayView<const Seg2> segs);
+
+    std::size_t size() const { return leftX_.size(); }
+
+    Vector2d left(int s) const { return {leftX_[s], leftY_[s]}; }
+    Vector2d right(int s) const { return {rightX_[s], rightY_[s]}; }
+    bool isVertical(int s) const { return leftX_[s] == rightX_[s]; }
+
+    // Infinite for vertical segments, whose intercept is zero.
+    double slope(int s) const { return slope_[s]; }
+    double intercept(int s) const { return intercept_[s]; }
+
+    // Height of the line through a non-vertical segment at x, rounded.
+    double heightAt(int s, double x) const {
+        return slope_[s] * x + intercept_[s];
+    }
+
+    // Sign of the height of non-vertical a minus the height of non-vertical
+    // b at x, exact.
+    int compareHeights(int a, int b, double x) const {
+        const double diff = heightAt(a, x) - heightAt(b, x);
+        if (Math::abs(diff) > heightError(a, x) + heightError(b, x))
+            return sign(diff);
+        return compareHeightsExact(a, b, x);
+    }
+
+    // Sign of the height of non-vertical s at x minus y, exact.
+    int compareHeight(int s, double x, double y) const {
+        const double diff = heightAt(s, x) - y;
+        if (Math::abs(diff) > heightError(s, x))
+            return sign(diff);
+        return compareHeightExact(s, x, y);
+    }
+
+    // The same at the x of an exact point, such as a computed crossing,
+    // filtered with the bounds on its rounded coordinates.
+    int compareHeights(int a, int b, const ExactPoint& p) const {
+        const double x = p.approximate().x();
+        const double diff = heightAt(a, x) - heightAt(b, x);
+        if (Math::abs(diff) >
+            (heightError(a, x) + heightError(b, x) +
+             Math::abs(slope_[a] - slope_[b]) * p.error().x()) *
+                (1.0 + 4.0 * std::numeric_limits<double>::epsilon()))
+            return sign(diff);
+        if (!p.isCrossing())
+            return compareHeightsExact(a, b, x);
+        return compareSegmentHeights(left(a), right(a), left(b), right(b),
+                                     p);
+    }
+
+    // Sign of the height of non-vertical s at the x of p minus the height
+    // of p, exact.
+    int compareHeight(int s, const ExactPoint& p) const {
+        const double x = p.approximate().x(), y = p.approximate().y();
+        const double diff = heightAt(s, x) - y;
+        if (Math::abs(diff) >
+            (heightError(s, x) + Math::abs(slope_[s]) * p.error().x() +
+             p.error().y()) *
+                (1.0 + 4.0 * std::numeric_limits<double>::epsilon()))
+            return sign(diff);
+        if (!p.isCrossing())
+            return compareHeightExact(s, x, y);
+        return compareLineHeight(left(s), right(s), p);
+    }
+
+    // Sign of the height of non-vertical s at the x of p minus y, exact.
+    int compareHeight(int s, const ExactPoint& p, double y) const {
+        const double x = p.approximate().x();
+        const double diff = heightAt(s, x) - y;
+        if (Math::abs(diff) >
+            (heightError(s, x) + Math::abs(slope_[s]) * p.error().x()) *
+                (1.0 + 4.0 * std::numeric_limits<double>::epsilon()))
+            return sign(diff);
+        if (!p.isCrossing())
+            return compareHeightExact(s, x, y);
+        return compareLineHeight(left(s), right(s), p, y);
+    }
+
+    // Sign of the slope of a minus the slope of b, exact. Vertical segments
+    // are steepest.
+    int compareSlopes(int a, int b) const {
+        if (isVertical(a) || isVertical(b))
+            return int(isVertical(a)) - int(isVertical(b));
+        const double diff = slope_[a] - slope_[b];
+        if (Math::abs(diff) >
+            8.0 * std::numeric_limits<double>::epsilon() *
+                (Math::abs(slope_[a]) + Math::abs(slope_[b])))
+            return sign(diff);
+        return compareSlopesExact(a, b);
+    }
+
+    // Whether the bounding boxes of a and b overlap, touching included.
+    bool boxesOverlap(int a, int b) const {
+        return leftX_[a] <= rightX_[b] && leftX_[b] <= rightX_[a] &&
+               Math::max(leftY_[a], rightY_[a]) >=
+                   Math::min(leftY_[b], rightY_[b]) &&
+               Math::max(leftY_[b], rightY_[b]) >=
+                   Math::min(leftY_[a], rightY_[a]);
+    }
+
+    // Same as Seg2::doesIntersect(), touching and collinear overlapping
+    // segments intersect. Pairs with disjoint bounding boxes are rejected
+    // before any predicate runs.
+    bool intersects(int a, int b) const;
+
+    // The arrays themselves, for batched kernels.
+    const std::vector<double>& leftX() const { return leftX_; }
+    const std::vector<double>& leftY() const { return leftY_; }
+    const std::vector<double>& rightX() const { return rightX_; }
+    const std::vector<double>& rightY() const { return rightY_; }
+
+  private:
+    static int sign(double value) {
+        return int(value > 0.0) - int(value < 0.0);
+    }
+
+    // Bound on the rounding error of heightAt(s, x), from the rounding of
+    // the slope, the intercept and the multiply-add.
+    double heightError(int s, double x) const {
+        return 8.0 * std::numeric_limits<double>::epsilon() *
+               (Math::abs(slope_[s]) *
+                    (Math::abs(x) + Math::abs(leftX_[s])) +
+                Math::abs(leftY_[s]));
+    }
+
+    int compareHeightsExact(int a, int b, double x) const;
+    int compareHeightExact(int s, double x, double y) const;
+    int compareSlopesExact(int a, int b) const;
+
+    std::vector<double> leftX_, leftY_, rightX_, rightY_;
+    std::vector<double> slope_, intercept_;
+};
+
+} // namespace CompGeom
+
+#endif
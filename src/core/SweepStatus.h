@@ -0,0 +1,312 @@
+#ifndef COMP_GEOM_CORE_SWEEPSTATUS_H
+#define COMP_GEOM_CORE_SWEEPSTATUS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <set>
+#include <vector>
+
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Ordered containers for the segments crossing a sweep line. They hold
+// segment indices in [0, segmentCount), each at most once, ordered by a
+// Less functor comparing two indices. Less may also be called with keys
+// that are never stored, e.g. a probe for the event point.
+//
+// Segments are their own handles: next() and prev() step from a stored
+// segment to its neighbours, StatusEnd marks the position past the last
+// segment and prev(StatusEnd) is the last segment, like --end().
+constexpr int StatusEnd = -2;
+
+// std::set based status, one heap allocated node per insertion.
+template <class Less> class SetStatus {
+  public:
+    SetStatus(std::size_t segmentCount, Less less)
+        : set_(less), where_(segmentCount), in_(segmentCount, 0) {}
+
+    bool contains(int s) const { return in_[s] != 0; }
+
+    void insert(int s) {
+        where_[s] = set_.insert(s).first;
+        in_[s] = 1;
+    }
+
+    void erase(int s) {
+        set_.erase(where_[s]);
+        in_[s] = 0;
+    }
+
+    // First segment not less than key.
+    int lowerBound(int key) const { return at(set_.lower_bound(key)); }
+
+    int next(int s) const { return at(std::next(where_[s])); }
+
+    int prev(int s) const {
+        const auto it = s == StatusEnd ? set_.end() : where_[s];
+        return it == set_.begin() ? StatusEnd : *std::prev(it);
+    }
+
+  private:
+    typedef std::set<int, Less> Set;
+
+    int at(typename Set::const_iterator it) const {
+        return it == set_.end() ? StatusEnd : *it;
+    }
+
+    Set set_;
+    std::vector<typename Set::const_iterator> where_;
+    std::vector<char> in_;
+};
+
+// Fixed size blocks handed out from large chunks and recycled through a free
+// list, never returned to the system before the arena is destroyed.
+class NodeArena {
+  public:
+    explicit NodeArena(std::size_t blocksPerChunk = 4096)
+        : blocksPerChunk_(blocksPerChunk) {}
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    // The block size is fixed by the first request, others of a different
+    // size go to the global heap.
+    void* allocate(std::size_t bytes) {
+        if (blockSize_ == 0)
+            blockSize_ = roundUp(bytes);
+        if (roundUp(bytes) != blockSize_)
+            return ::operator new(bytes);
+        if (!free_) {
+            chunks_.emplace_back(new unsigned char[blockSize_ *
+                                                   blocksPerChunk_]);
+            unsigned char* chunk = chunks_.back().get();
+            for (std::size_t i = blocksPerChunk_; i-- > 0;)
+                push(chunk + i * blockSize_);
+        }
+        FreeBlock* block = free_;
+        free_ = block->next;
+        return block;
+    }
+
+    void deallocate(void* pointer, std::size_t bytes) {
+        if (roundUp(bytes) != blockSize_)
+            return ::operator delete(pointer);
+        push(pointer);
+    }
+
+  private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static std::size_t roundUp(std::size_t bytes) {
+        const std::size_t align = alignof(std::max_align_t);
+        return (std::max(bytes, sizeof(FreeBlock)) + align - 1) / align *
+               align;
+    }
+
+    void push(void* pointer) {
+        FreeBlock* block = static_cast<FreeBlock*>(pointer);
+        block->next = free_;
+        free_ = block;
+    }
+
+    std::size_t blocksPerChunk_;
+    std::size_t blockSize_ = 0;
+    FreeBlock* free_ = nullptr;
+    std::vector<std::unique_ptr<unsigned char[]>> chunks_;
+};
+
+// Allocator drawing single nodes from a NodeArena.
+template <class T> struct ArenaAllocator {
+    typedef T value_type;
+
+    explicit ArenaAllocator(NodeArena& arena) : arena(&arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(std::size_t n) {
+        if (n != 1)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(arena->allocate(sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n) {
+        if (n != 1)
+            return ::operator delete(pointer);
+        arena->deallocate(pointer, sizeof(T));
+    }
+
+    NodeArena* arena;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena == b.arena;
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena != b.arena;
+}
+
+// std::set based status with its nodes recycled from an arena, so the
+// steady stream of inserts and erases doesn't go through the heap.
+template <class Less> class ArenaSetStatus {
+  public:
+    ArenaSetStatus(std::size_t segmentCount, Less less)
+        : set_(less, ArenaAllocator<int>{*arena_}), where_(segmentCount),
+          in_(segmentCount, 0) {}
+
+    bool contains(int s) const { return in_[s] != 0; }
+
+    void insert(int s) {
+        where_[s] = set_.insert(s).first;
+        in_[s] = 1;
+    }
+
+    void erase(int s) {
+        set_.erase(where_[s]);
+        in_[s] = 0;
+    }
+
+    int lowerBound(int key) const { return at(set_.lower_bound(key)); }
+
+    int next(int s) const { return at(std::next(where_[s])); }
+
+    int prev(int s) const {
+        const auto it = s == StatusEnd ? set_.end() : where_[s];
+        return it == set_.begin() ? StatusEnd : *std::prev(it);
+    }
+
+  private:
+    typedef std::set<int, Less, ArenaAllocator<int>> Set;
+
+    int at(typename Set::const_iterator it) const {
+        return it == set_.end() ? StatusEnd : *it;
+    }
+
+    // Declared first so it outlives the set's nodes.
+    std::unique_ptr<NodeArena> arena_{new NodeArena};
+    Set set_;
+    std::vector<typename Set::const_iterator> where_;
+    std::vector<char> in_;
+};
+
+// Skip list over segment indices. The height of every segment's tower is
+// drawn up front and all towers are packed in two flat arrays of next and
+// prev links, so nothing is allocated while sweeping and the links of a
+// segment sit next to each other. With prev links at every level erase
+// needs no comparisons, only searches (insert, lowerBound) call Less.
+template <class Less> class SkipListStatus {
+  public:
+    SkipListStatus(std::size_t segmentCount, Less less)
+        : less_(less), head_(int(segmentCount)), offset_(segmentCount + 2),
+          in_(segmentCount, 0) {
+        // Tower heights are geometric with p = 1/4, from a fixed seed so
+        // runs are reproducible.
+        std::uint64_t state = 0x9e3779b97f4a7c15ull;
+        offset_[0] = 0;
+        for (std::size_t s = 0; s < segmentCount; ++s) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            std::uint64_t bits = state >> 32;
+            int height = 1;
+            while (height < MaxHeight && (bits & 3) == 0) {
+                ++height;
+                bits >>= 2;
+            }
+            offset_[s + 1] = offset_[s] + height;
+        }
+        // The head tower has full height, its links at level 0 make the list
+        // circular so prev(StatusEnd) is the last segment.
+        offset_[segmentCount + 1] = offset_[segmentCount] + MaxHeight;
+        next_.assign(offset_.back(), head_);
+        prev_.assign(offset_.back(), head_);
+    }
+
+    bool contains(int s) const { return in_[s] != 0; }
+
+    void insert(int s) {
+        int update[MaxHeight];
+        search(s, update);
+        const int height = towerHeight(s);
+        for (; levels_ < height; ++levels_)
+            update[levels_] = head_;
+        for (int level = 0; level < height; ++level) {
+            const int before = update[level];
+            const int after = link(next_, before, level);
+            link(next_, s, level) = after;
+            link(prev_, s, level) = before;
+            link(next_, before, level) = s;
+            link(prev_, after, level) = s;
+        }
+        in_[s] = 1;
+    }
+
+    void erase(int s) {
+        const int height = towerHeight(s);
+        for (int level = 0; level < height; ++level) {
+            const int before = link(prev_, s, level);
+            const int after = link(next_, s, level);
+            link(next_, before, level) = after;
+            link(prev_, after, level) = before;
+        }
+        in_[s] = 0;
+    }
+
+    int lowerBound(int key) const {
+        int update[MaxHeight];
+        search(key, update);
+        return end(link(next_, update[0], 0));
+    }
+
+    int next(int s) const { return end(link(next_, s, 0)); }
+
+    int prev(int s) const {
+        return end(link(prev_, s == StatusEnd ? head_ : s, 0));
+    }
+
+  private:
+    // Enough for 4^16 segments before towers get capped.
+    static constexpr int MaxHeight = 16;
+
+    int towerHeight(int s) const { return offset_[s + 1] - offset_[s]; }
+
+    int& link(std::vector<int>& links, int s, int level) {
+        return links[offset_[s] + level];
+    }
+    int link(const std::vector<int>& links, int s, int level) const {
+        return links[offset_[s] + level];
+    }
+
+    int end(int s) const { return s == head_ ? StatusEnd : s; }
+
+    // Fills update with the last tower at each used level that is less than
+    // key.
+    void search(int key, int (&update)[MaxHeight]) const {
+        int at = head_;
+        for (int level = levels_ - 1; level >= 0; --level) {
+            for (int s = link(next_, at, level); s != head_ && less_(s, key);
+                 s = link(next_, at, level))
+                at = s;
+            update[level] = at;
+        }
+    }
+
+    Less less_;
+    int head_;
+    // Levels any tower inserted so far reaches.
+    int levels_ = 1;
+    std::vector<int> offset_;
+    std::vector<int> next_, prev_;
+    std::vector<char> in_;
+};
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
+
+#include "core/CompGeomCore.h"
+#include "core/Predicates.h"
+
+namespace CompGeom {
+namespace Test {
+namespace {
+
+struct DelaunayTest : TestSuite::Tester {
+    explicit DelaunayTest();
+
+    void triangulation();
+    void allCollinear();
+};
+
+enum class Input {
+    Random,     // Uniform points.
+    Clusters,   // Gaussian clusters, long thin triangles between them.
+    Grid,       // Integer grid, every square's corners cocircular.
+    Duplicates, // Points on a small grid, most of them repeated.
+    Collinear   // A line of points and a few off it.
+};
+
+const struct {
+    const char* name;
+    Input input;
+} InputData[]{{"random", Input::Random},
+              {"clusters", Input::Clusters},
+              {"grid", Input::Grid},
+              {"duplicates", Input::Duplicates},
+              {"collinear", Input::Collinear}};
+
+std::vector<Vector2> points(Input input, std::uint32_t seed) {
+    std::mt19937 random{seed};
+    std::vector<Vector2> out;
+    switch (input) {
+    case Input::Random:
+        out.resize(400);
+        generatePoints(out, PointDistribution::Uniform, seed, 1000.0f, 1);
+        return out;
+    case Input::Clusters:
+        out.resize(400);
+        generatePoints(out, PointDistribution::GaussianClusters, seed,
+                       1000.0f, 1);
+        return out;
+    case Input::Grid:
+        for (int x = 0; x != 15; ++x) {
+            for (int y = 0; y != 12; ++y)
+                out.emplace_back(float(x), float(y));
+        }
+        break;
+    case Input::Duplicates: {
+        std::uniform_int_distribution<int> coordinate{0, 9};
+        for (int i = 0; i != 300; ++i)
+            out.emplace_back(float(coordinate(random)),
+                             float(coordinate(random)));
+        break;
+    }
+    case Input::Collinear: {
+        std::uniform_int_distribution<int> step{-100, 100};
+        for (int i = 0; i != 150; ++i) {
+            const float t = float(step(random));
+            out.emplace_back(t, 0.5f * t + 3.0f);
+        }
+        for (int i = 0; i != 3; ++i)
+            out.emplace_back(float(step(random)), float(step(random)));
+        break;
+    }
+    }
+    std::shuffle(out.begin(), out.end(), random);
+    return out;
+}
+
+bool lexLess(const Vector2& a, const Vector2& b) {
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+}
+
+// Distinct points on the convex hull boundary, the ones inside hull edges
+// included.
+std::size_t hullBoundaryPoints(const std::vector<Vector2>& distinct) {
+    const std::vector<Vector2> hull =
+        compute2DConvexHullMonotoneChain(distinct);
+    std::size_t count = 0;
+    for (const Vector2& p : distinct) {
+        for (std::size_t i = 0; i + 1 < hull.size(); ++i) {
+            const Vector2& a = hull[i];
+            const Vector2& b = hull[i + 1];
+            if (orient2d(a, b, p) == 0.0 &&
+                p.x() >= std::min(a.x(), b.x()) &&
+                p.x() <= std::max(a.x(), b.x()) &&
+                p.y() >= std::min(a.y(), b.y()) &&
+                p.y() <= std::max(a.y(), b.y())) {
+                ++count;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+DelaunayTest::DelaunayTest() {
+    addInstancedTests({&DelaunayTest::triangulation},
+                      Containers::arraySize(InputData));
+    addTests({&DelaunayTest::allCollinear});
+}
+
+void DelaunayTest::triangulation() {
+    auto&& data = InputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for (std::uint32_t seed = 0; seed != 10; ++seed) {
+        CORRADE_ITERATION(seed);
+        const std::vector<Vector2> input = points(data.input, seed);
+        const DelaunayTriangulation result =
+            computeDelaunayTriangulation(input);
+        const std::vector<std::uint32_t>& t = result.triangles;
+        CORRADE_COMPARE(result.neighbours.size(), t.size());
+
+        std::vector<Vector2> distinct{input};
+        std::sort(distinct.begin(), distinct.end(), lexLess);
+        distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                       distinct.end());
+        // Euler's formula for a triangulation of n points, h of them on
+        // the hull boundary.
+        CORRADE_COMPARE(result.size(), 2 * distinct.size() - 2 -
+                                           hullBoundaryPoints(distinct));
+
+        // Every distinct point is used through exactly one of its copies.
+        std::vector<bool> used(input.size());
+        for (const std::uint32_t i : t) {
+            CORRADE_VERIFY(i < input.size());
+            used[i] = true;
+        }
+        std::vector<Vector2> usedPoints;
+        for (std::size_t i = 0; i != input.size(); ++i) {
+            if (used[i])
+                usedPoints.push_back(input[i]);
+        }
+        std::sort(usedPoints.begin(), usedPoints.end(), lexLess);
+        CORRADE_COMPARE(usedPoints, distinct);
+
+        for (std::size_t a = 0; a != result.size(); ++a) {
+            const Vector2& p0 = input[t[3 * a]];
+            const Vector2& p1 = input[t[3 * a + 1]];
+            const Vector2& p2 = input[t[3 * a + 2]];
+            CORRADE_VERIFY(orient2d(p0, p1, p2) > 0.0);
+
+            // The neighbour across the edge opposite vertex i has the same
+            // edge the other way round, and this triangle across it.
+            for (int i = 0; i != 3; ++i) {
+                const std::uint32_t b = result.neighbours[3 * a + i];
+                if (b == DelaunayNoNeighbour)
+                    continue;
+                CORRADE_VERIFY(b < result.size());
+                const std::uint32_t from = t[3 * a + (i + 1) % 3];
+                const std::uint32_t to = t[3 * a + (i + 2) % 3];
+                int j = 0;
+                while (j != 3 && result.neighbours[3 * b + j] != a)
+                    ++j;
+                CORRADE_VERIFY(j != 3);
+                CORRADE_COMPARE(t[3 * b + (j + 1) % 3], to);
+                CORRADE_COMPARE(t[3 * b + (j + 2) % 3], from);
+            }
+
+            // Empty circumcircles, with the exact predicate.
+            for (const Vector2& q : input)
+                CORRADE_VERIFY(incircle(p0, p1, p2, q) <= 0.0);
+        }
+
+        // The edges without a neighbour go round the hull, one per point
+        // on its boundary.
+        std::size_t hullEdges = 0;
+        for (const std::uint32_t b : result.neighbours)
+            hullEdges += b == DelaunayNoNeighbour;
+        CORRADE_COMPARE(hullEdges, hullBoundaryPoints(distinct));
+    }
+}
+
+void DelaunayTest::allCollinear() {
+    std::vector<Vector2> input;
+    for (int i = 0; i != 50; ++i)
+        input.emplace_back(float(i % 17), float(2 * (i % 17)) - 1.0f);
+    const DelaunayTriangulation result = computeDelaunayTriangulation(input);
+    CORRADE_COMPARE(result.size(), std::size_t(0));
+    CORRADE_COMPARE(result.neighbours.size(), std::size_t(0));
+}
+
+} // namespace
+} // namespace Test
+} // namespace CompGeom
+
+CORRADE_TEST_MAIN(CompGeom::Test::DelaunayTest)
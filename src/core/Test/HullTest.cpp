@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
+
+#include "core/CompGeomCore.h"
+
+namespace CompGeom {
+namespace Test {
+namespace {
+
+struct HullTest : TestSuite::Tester {
+    explicit HullTest();
+
+    void algorithmsAgree();
+    void prefilterKeepsHull();
+};
+
+// The generatePoints() distributions, then inputs with points inside hull
+// edges and repeated points, where the algorithms used to disagree.
+enum class Input {
+    Uniform,
+    Circle, // Every point on the hull.
+    GaussianClusters,
+    Grid,      // Integer grid, many points inside hull edges.
+    Collinear, // All points on one line, in random order.
+    Duplicates // Few distinct points, each many times.
+};
+
+const struct {
+    const char* name;
+    Input input;
+} InputData[]{{"uniform", Input::Uniform},
+              {"circle", Input::Circle},
+              {"gaussian clusters", Input::GaussianClusters},
+              {"grid", Input::Grid},
+              {"collinear", Input::Collinear},
+              {"duplicates", Input::Duplicates}};
+
+std::vector<Vector2> generated(PointDistribution distribution,
+                               std::uint32_t seed) {
+    // Not a multiple of the chunk and vector sizes.
+    std::vector<Vector2> points(1001);
+    generatePoints(points, distribution, seed, 1000.0f, 1);
+    return points;
+}
+
+std::vector<Vector2> points(Input input, std::uint32_t seed) {
+    std::mt19937 random{seed};
+    std::vector<Vector2> out;
+    switch (input) {
+    case Input::Uniform:
+        return generated(PointDistribution::Uniform, seed);
+    case Input::Circle:
+        return generated(PointDistribution::Circle, seed);
+    case Input::GaussianClusters:
+        return generated(PointDistribution::GaussianClusters, seed);
+    case Input::Grid:
+        for (int x = 0; x != 17; ++x) {
+            for (int y = 0; y != 13; ++y)
+                out.emplace_back(float(x), float(y));
+        }
+        break;
+    case Input::Collinear: {
+        std::uniform_int_distribution<int> step{-50, 50};
+        for (int i = 0; i != 200; ++i) {
+            const float t = float(step(random));
+            out.emplace_back(3.0f * t, 1.0f - 2.0f * t);
+        }
+        break;
+    }
+    case Input::Duplicates: {
+        std::uniform_int_distribution<int> coordinate{0, 4};
+        std::vector<Vector2> distinct;
+        for (int i = 0; i != 8; ++i)
+            distinct.emplace_back(float(coordinate(random)),
+                                  float(coordinate(random)));
+        std::uniform_int_distribution<std::size_t> pick{0, 7};
+        for (int i = 0; i != 300; ++i)
+            out.push_back(distinct[pick(random)]);
+        break;
+    }
+    }
+    std::shuffle(out.begin(), out.end(), random);
+    return out;
+}
+
+// Points the Akl-Toussaint prefilter has to keep although they are within
+// rounding distance of its polygon, where the margin decides.
+enum class PrefilterInput {
+    Circle,         // Every point on the hull, close to the polygon.
+    Octagon,        // On the edges of the eight direction polygon.
+    Diamond,        // On the edges of the four direction polygon.
+    OctagonFarAway, // The octagon around (10^5, 10^5).
+    Clusters        // Mostly interior points.
+};
+
+const struct {
+    const char* name;
+    PrefilterInput input;
+} PrefilterData[]{{"circle", PrefilterInput::Circle},
+                  {"octagon", PrefilterInput::Octagon},
+                  {"diamond", PrefilterInput::Diamond},
+                  {"octagon far away", PrefilterInput::OctagonFarAway},
+                  {"clusters", PrefilterInput::Clusters}};
+
+// Points on the edges of the polygon with the given corners, rounded to
+// float and then nudged up to two floats either way, plus as many random
+// points inside.
+std::vector<Vector2> nearPolygon(const std::vector<Vector2>& corners,
+                                 std::uint32_t seed) {
+    std::mt19937 random{seed};
+    std::uniform_real_distribution<double> along{0.0, 1.0};
+    std::uniform_int_distribution<int> nudge{-2, 2};
+    std::vector<Vector2> out(corners);
+    for (int i = 0; i != 600; ++i) {
+        const Vector2d a{corners[i % corners.size()]};
+        const Vector2d b{corners[(i + 1) % corners.size()]};
+        Vector2 p{a + (b - a) * along(random)};
+        for (int n = nudge(random); n != 0; n += n > 0 ? -1 : 1)
+            p.x() = std::nextafter(p.x(), n > 0 ? HUGE_VALF : -HUGE_VALF);
+        for (int n = nudge(random); n != 0; n += n > 0 ? -1 : 1)
+            p.y() = std::nextafter(p.y(), n > 0 ? HUGE_VALF : -HUGE_VALF);
+        out.push_back(p);
+    }
+    const Vector2 centre = (corners[0] + corners[corners.size() / 2]) / 2.0f;
+    std::uniform_real_distribution<float> inside{-0.5f, 0.5f};
+    const float size = (corners[0] - centre).length();
+    for (int i = 0; i != 600; ++i)
+        out.push_back(centre + Vector2{inside(random), inside(random)} * size);
+    std::shuffle(out.begin(), out.end(), random);
+    return out;
+}
+
+std::vector<Vector2> regularPolygon(int corners, const Vector2& centre,
+                                    float radius) {
+    std::vector<Vector2> out;
+    for (int i = 0; i != corners; ++i) {
+        const double angle = 6.283185307179586 * i / corners;
+        out.push_back(centre + Vector2{float(radius * std::cos(angle)),
+                                       float(radius * std::sin(angle))});
+    }
+    return out;
+}
+
+std::vector<Vector2> prefilterPoints(PrefilterInput input,
+                                     std::uint32_t seed) {
+    switch (input) {
+    case PrefilterInput::Circle:
+        return generated(PointDistribution::Circle, seed);
+    case PrefilterInput::Octagon:
+        return nearPolygon(regularPolygon(8, {}, 1000.0f), seed);
+    case PrefilterInput::Diamond:
+        return nearPolygon(regularPolygon(4, {}, 1000.0f), seed);
+    case PrefilterInput::OctagonFarAway:
+        return nearPolygon(regularPolygon(8, Vector2{100000.0f}, 1000.0f),
+                           seed);
+    case PrefilterInput::Clusters:
+        return generated(PointDistribution::GaussianClusters, seed);
+    }
+    return {};
+}
+
+HullTest::HullTest() {
+    addInstancedTests({&HullTest::algorithmsAgree},
+                      Containers::arraySize(InputData));
+    addInstancedTests({&HullTest::prefilterKeepsHull},
+                      Containers::arraySize(PrefilterData));
+}
+
+// Every algorithm promises the same closed polyline, so they are compared
+// exactly against the monotone chain, without the prefilter.
+void HullTest::algorithmsAgree() {
+    auto&& data = InputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for (std::uint32_t seed = 0; seed != 10; ++seed) {
+        CORRADE_ITERATION(seed);
+        const std::vector<Vector2> input = points(data.input, seed);
+        const std::vector<Vector2> expected =
+            compute2DConvexHullMonotoneChain(input);
+        CORRADE_VERIFY(expected.size() >= 3);
+
+        for (const HullAlgorithm algorithm :
+             {HullAlgorithm::JarvisMarch, HullAlgorithm::MonotoneChain,
+              HullAlgorithm::Chan, HullAlgorithm::Parallel}) {
+            CORRADE_COMPARE(computeConvexHull2D(input, algorithm,
+                                                HullPrefilter::None),
+                            expected);
+
+            std::vector<Vector2> streamed;
+            forEachConvexHullVertex(input,
+                                    [&](const Vector2& vertex) {
+                                        streamed.push_back(vertex);
+                                        return true;
+                                    },
+                                    algorithm, HullPrefilter::None);
+            CORRADE_COMPARE(streamed, expected);
+            CORRADE_COMPARE(countConvexHullVertices(input, algorithm,
+                                                    HullPrefilter::None),
+                            expected.size() - 1);
+        }
+
+        for (const unsigned threads : {1u, 2u, 3u, 8u})
+            CORRADE_COMPARE(compute2DConvexHullParallel(input, threads),
+                            expected);
+
+        // Chunks small enough for many merges, added one by one and in
+        // uneven runs.
+        for (const std::size_t chunkSize : {std::size_t(4), std::size_t(64)}) {
+            StreamingConvexHull2D single{chunkSize};
+            for (const Vector2& p : input)
+                single.add(p);
+            CORRADE_COMPARE(single.hull(), expected);
+
+            StreamingConvexHull2D runs{chunkSize};
+            for (std::size_t i = 0; i < input.size(); i += 37)
+                runs.add(Containers::ArrayView<const Vector2>{
+                    input.data() + i,
+                    std::min<std::size_t>(37, input.size() - i)});
+            CORRADE_COMPARE(runs.pointCount(), input.size());
+            CORRADE_COMPARE(runs.hull(), expected);
+        }
+    }
+}
+
+// Whichever of the AVX2, SSE2 and scalar paths the build has, the scalar
+// one also takes the tail of the vector loops. Short prefixes of the input
+// run through the tail alone.
+void HullTest::prefilterKeepsHull() {
+    auto&& data = PrefilterData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for (std::uint32_t seed = 0; seed != 10; ++seed) {
+        CORRADE_ITERATION(seed);
+        const std::vector<Vector2> input = prefilterPoints(data.input, seed);
+        std::vector<Containers::ArrayView<const Vector2>> prefixes{input};
+        for (std::size_t n = 4; n != 20; ++n)
+            prefixes.emplace_back(input.data(), n);
+
+        for (const Containers::ArrayView<const Vector2> points : prefixes) {
+            for (const HullAlgorithm algorithm :
+                 {HullAlgorithm::MonotoneChain, HullAlgorithm::Chan}) {
+                const std::vector<Vector2> expected =
+                    computeConvexHull2D(points, algorithm,
+                                        HullPrefilter::None);
+                for (const HullPrefilter prefilter :
+                     {HullPrefilter::FourDirections,
+                      HullPrefilter::EightDirections}) {
+                    std::size_t removed = 0;
+                    CORRADE_COMPARE(computeConvexHull2D(points, algorithm,
+                                                        prefilter, &removed),
+                                    expected);
+
+                    std::vector<Vector2> kept;
+                    CORRADE_COMPARE(
+                        aklToussaintPrefilter(points, kept, prefilter),
+                        points.size() - kept.size());
+                    // Every hull vertex is kept, in whatever order.
+                    for (const Vector2& vertex : expected)
+                        CORRADE_VERIFY(std::find(kept.begin(), kept.end(),
+                                                 vertex) != kept.end());
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+} // namespace Test
+} // namespace CompGeom
+
+CORRADE_TEST_MAIN(CompGeom::Test::HullTest)
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
+
+#include "core/CompGeomCore.h"
+
+namespace CompGeom {
+namespace Test {
+namespace {
+
+struct IntersectionTest : TestSuite::Tester {
+    explicit IntersectionTest();
+
+    void sweepMatchesBruteForce();
+    void parallelMatchesSerial();
+};
+
+// Inputs where rounding used to decide whether a crossing is found once,
+// twice or not at all.
+enum class Input {
+    Random,           // Uniform segments, nothing degenerate on purpose.
+    IntegerGrid,      // Endpoints on a tiny grid, touching and overlapping.
+    CollinearOverlap, // Chains of overlapping segments on a few lines.
+    ThroughOnePoint,  // Many lines through points floats can't represent.
+    NearlyConcurrent, // Long segments through almost the same point.
+    NearlyParallel    // Slopes a few units of 2^-20 apart.
+};
+
+const struct {
+    const char* name;
+    Input input;
+} InputData[]{{"random", Input::Random},
+              {"integer grid", Input::IntegerGrid},
+              {"collinear overlap", Input::CollinearOverlap},
+              {"many through one point", Input::ThroughOnePoint},
+              {"nearly concurrent", Input::NearlyConcurrent},
+              {"nearly parallel", Input::NearlyParallel}};
+
+const SweepStatus Statuses[]{SweepStatus::Set, SweepStatus::ArenaSet,
+                             SweepStatus::SkipList};
+
+std::vector<Seg2> randomSegments(std::uint32_t seed) {
+    std::vector<Seg2> segs(300, Seg2{Vector2{}, Vector2{}});
+    generateSegments(segs, SegmentDistribution::Uniform, seed, 1000.0f, 1);
+    return segs;
+}
+
+// Endpoints on a 9x9 grid, so many segments share endpoints, touch an
+// interior point or overlap. Zero length segments are left out.
+std::vector<Seg2> integerGridSegments(std::uint32_t seed) {
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<int> coordinate{0, 8};
+    std::vector<Seg2> segs;
+    while (segs.size() < 150) {
+        const Vector2 p{float(coordinate(random)), float(coordinate(random))};
+        const Vector2 q{float(coordinate(random)), float(coordinate(random))};
+        if (p != q)
+            segs.emplace_back(p, q);
+    }
+    return segs;
+}
+
+// Runs of integer steps along a horizontal, a vertical and two slanted
+// lines, overlapping each other and crossed by a few random segments.
+std::vector<Seg2> collinearOverlapSegments(std::uint32_t seed) {
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<int> step{-6, 6};
+    const Vector2 origins[]{{0.0f, 3.0f}, {2.0f, 0.0f}, {0.0f, 0.0f},
+                            {0.0f, 1.0f}};
+    const Vector2 directions[]{{1.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f},
+                               {3.0f, 1.0f}};
+    std::vector<Seg2> segs;
+    for (int line = 0; line != 4; ++line) {
+        for (int i = 0; i != 12; ++i) {
+            int a = step(random), b = step(random);
+            if (a == b)
+                continue;
+            segs.emplace_back(origins[line] + directions[line] * float(a),
+                              origins[line] + directions[line] * float(b));
+        }
+    }
+    std::uniform_real_distribution<float> coordinate{-6.0f, 6.0f};
+    for (int i = 0; i != 10; ++i)
+        segs.emplace_back(Vector2{coordinate(random), coordinate(random)},
+                          Vector2{coordinate(random), coordinate(random)});
+    return segs;
+}
+
+// Segments between integer points whose lines pass through (1/3, 1/3), so
+// every pair crosses at the same point that has no float representation,
+// plus ones symmetric around (2, 2).
+std::vector<Seg2> throughOnePointSegments(std::uint32_t seed) {
+    std::vector<Seg2> candidates;
+    for (int ux = -6; ux <= 6; ++ux) {
+        for (int uy = -6; uy <= 0; ++uy) {
+            for (int vx = -6; vx <= 6; ++vx) {
+                for (int vy = 1; vy <= 6; ++vy) {
+                    // 3 (v - u) x (c - u) with c = (1/3, 1/3), in integers.
+                    const int cross = (vx - ux) * (1 - 3 * uy) -
+                                      (vy - uy) * (1 - 3 * ux);
+                    if (cross == 0)
+                        candidates.emplace_back(
+                            Vector2{float(ux), float(uy)},
+                            Vector2{float(vx), float(vy)});
+                }
+            }
+        }
+    }
+    std::mt19937 random{seed};
+    std::shuffle(candidates.begin(), candidates.end(), random);
+    if (candidates.size() > 40)
+        candidates.erase(candidates.begin() + 40, candidates.end());
+
+    std::uniform_int_distribution<int> offset{-8, 8};
+    for (int i = 0; i != 20; ++i) {
+        const Vector2 d{float(offset(random)) / 4.0f,
+                        float(offset(random)) / 4.0f};
+        if (d != Vector2{})
+            candidates.emplace_back(Vector2{2.0f} - d, Vector2{2.0f} + d);
+    }
+    return candidates;
+}
+
+// Segments through the origin, one end nudged by a few units of 2^-12,
+// so all of them cross within a tiny area at distinct but close points.
+std::vector<Seg2> nearlyConcurrentSegments(std::uint32_t seed) {
+    std::mt19937 random{seed};
+    std::uniform_real_distribution<float> coordinate{-1.0f, 1.0f};
+    std::uniform_int_distribution<int> offset{-12, 12};
+    const float unit = 1.0f / 4096.0f;
+    std::vector<Seg2> segs;
+    for (int i = 0; i != 200; ++i) {
+        const Vector2 end =
+            Vector2{coordinate(random), coordinate(random)} * 1000.0f;
+        segs.emplace_back(end,
+                          -end + Vector2{float(offset(random)) * unit, 0.0f});
+    }
+    return segs;
+}
+
+// Long segments whose ends are a few units of 2^-20 apart, so they cross
+// at badly conditioned points close to each other, some shared.
+std::vector<Seg2> nearlyParallelSegments(std::uint32_t seed) {
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<int> offset{-12, 12};
+    const float unit = 1.0f / 1048576.0f;
+    std::vector<Seg2> segs;
+    for (int i = 0; i != 80; ++i)
+        segs.emplace_back(Vector2{0.0f, 1.0f + float(offset(random)) * unit},
+                          Vector2{1024.0f,
+                                  1.0f + float(offset(random)) * unit});
+    return segs;
+}
+
+std::vector<Seg2> segments(Input input, std::uint32_t seed) {
+    switch (input) {
+    case Input::Random:
+        return randomSegments(seed);
+    case Input::IntegerGrid:
+        return integerGridSegments(seed);
+    case Input::CollinearOverlap:
+        return collinearOverlapSegments(seed);
+    case Input::ThroughOnePoint:
+        return throughOnePointSegments(seed);
+    case Input::NearlyConcurrent:
+        return nearlyConcurrentSegments(seed);
+    case Input::NearlyParallel:
+        return nearlyParallelSegments(seed);
+    }
+    return {};
+}
+
+// Reported pairs in order, duplicates kept so they show up as a mismatch.
+std::vector<std::pair<int, int>>
+pairs(const std::vector<SegmentIntersection>& intersections) {
+    std::vector<std::pair<int, int>> out;
+    for (const SegmentIntersection& i : intersections)
+        out.emplace_back(i.a, i.b);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+IntersectionTest::IntersectionTest() {
+    addInstancedTests({&IntersectionTest::sweepMatchesBruteForce,
+                       &IntersectionTest::parallelMatchesSerial},
+                      Containers::arraySize(InputData));
+}
+
+void IntersectionTest::sweepMatchesBruteForce() {
+    auto&& data = InputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for (std::uint32_t seed = 0; seed != 40; ++seed) {
+        CORRADE_ITERATION(seed);
+        const std::vector<Seg2> segs = segments(data.input, seed);
+        const std::vector<std::pair<int, int>> expected =
+            pairs(findSegmentIntersectionsBruteForce(segs));
+        CORRADE_COMPARE(pairs(findAllSegmentIntersections(segs)), expected);
+        for (const SweepStatus status : Statuses) {
+            std::vector<SegmentIntersection> swept;
+            sweepSegmentIntersections(
+                segs,
+                [&](int a, int b, const Vector2& point) {
+                    swept.push_back({a, b, point});
+                    return true;
+                },
+                status);
+            CORRADE_COMPARE(pairs(swept), expected);
+        }
+    }
+}
+
+// Slab boundaries are at quantiles of the endpoint x, so on the integer
+// inputs they fall on x shared by many endpoints, touching points and
+// crossings, each of which has to be reported by exactly one slab.
+void IntersectionTest::parallelMatchesSerial() {
+    auto&& data = InputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for (std::uint32_t seed = 0; seed != 10; ++seed) {
+        CORRADE_ITERATION(seed);
+        const std::vector<Seg2> segs = segments(data.input, seed);
+        const std::vector<std::pair<int, int>> expected =
+            pairs(findAllSegmentIntersections(segs));
+        for (const unsigned threads : {2u, 3u, 4u, 8u})
+            CORRADE_COMPARE(
+                pairs(findAllSegmentIntersectionsParallel(segs, threads)),
+                expected);
+    }
+}
+
+} // namespace
+} // namespace Test
+} // namespace CompGeom
+
+CORRADE_TEST_MAIN(CompGeom::Test::IntersectionTest)
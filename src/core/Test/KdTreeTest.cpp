@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
+
+#include "core/CompGeomCore.h"
+
+namespace CompGeom {
+namespace Test {
+namespace {
+
+struct KdTreeTest : TestSuite::Tester {
+    explicit KdTreeTest();
+
+    void nearest();
+    void withinRadius();
+};
+
+enum class Input {
+    Random,    // Uniform points.
+    Duplicates // Few distinct points on a grid, most of them repeated.
+};
+
+const struct {
+    const char* name;
+    Input input;
+} InputData[]{{"random", Input::Random}, {"duplicates", Input::Duplicates}};
+
+const unsigned ThreadCounts[]{1, 2, 3, 8};
+
+std::vector<Vector2> points(Input input, std::uint32_t seed) {
+    std::vector<Vector2> out;
+    switch (input) {
+    case Input::Random:
+        out.resize(1000);
+        generatePoints(out, PointDistribution::Uniform, seed, 100.0f, 1);
+        break;
+    case Input::Duplicates: {
+        std::mt19937 random{seed};
+        std::uniform_int_distribution<int> coordinate{0, 9};
+        for (int i = 0; i != 1000; ++i)
+            out.emplace_back(float(coordinate(random)),
+                             float(coordinate(random)));
+        break;
+    }
+    }
+    return out;
+}
+
+// Every input point, which is then its own nearest neighbour, followed by
+// as many random points around the input, so there are several blocks of
+// queries per thread.
+std::vector<Vector2> queries(const std::vector<Vector2>& input,
+                             std::uint32_t seed) {
+    std::vector<Vector2> out = input;
+    std::mt19937 random{seed};
+    std::uniform_real_distribution<float> coordinate{-10.0f, 110.0f};
+    for (std::size_t i = 0; i != input.size(); ++i)
+        out.emplace_back(coordinate(random), coordinate(random));
+    return out;
+}
+
+KdTreeTest::KdTreeTest() {
+    addInstancedTests({&KdTreeTest::nearest, &KdTreeTest::withinRadius},
+                      Containers::arraySize(InputData));
+}
+
+void KdTreeTest::nearest() {
+    auto&& data = InputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for (std::uint32_t seed = 0; seed != 5; ++seed) {
+        CORRADE_ITERATION(seed);
+        const std::vector<Vector2> input = points(data.input, seed);
+        const std::vector<Vector2> query = queries(input, seed);
+
+        for (const std::size_t k :
+             {std::size_t(1), std::size_t(7), input.size() + 3}) {
+            const std::vector<std::uint32_t> expected =
+                findNearestNeighboursBruteForce(input, query, k);
+            CORRADE_COMPARE(expected.size(), query.size() * k);
+            const std::size_t count = std::min(k, input.size());
+            for (const unsigned threads : ThreadCounts) {
+                const KdTree2D tree{input, threads};
+                const std::vector<std::uint32_t> found =
+                    findNearestNeighbours(tree, query, k, threads);
+                CORRADE_COMPARE(found.size(), expected.size());
+
+                // Ties go to any of the closest, so compare the distances
+                // and check the indices are distinct input points.
+                std::vector<std::uint32_t> sorted;
+                for (std::size_t q = 0; q != query.size(); ++q) {
+                    sorted.clear();
+                    for (std::size_t i = q * k; i != (q + 1) * k; ++i) {
+                        CORRADE_COMPARE(found[i] == KdTreeNoPoint,
+                                        expected[i] == KdTreeNoPoint);
+                        if (found[i] == KdTreeNoPoint)
+                            continue;
+                        CORRADE_VERIFY(found[i] < input.size());
+                        CORRADE_COMPARE((input[found[i]] - query[q]).dot(),
+                                        (input[expected[i]] - query[q]).dot());
+                        sorted.push_back(found[i]);
+                    }
+                    CORRADE_COMPARE(sorted.size(), count);
+                    std::sort(sorted.begin(), sorted.end());
+                    CORRADE_VERIFY(std::adjacent_find(sorted.begin(),
+                                                      sorted.end()) ==
+                                   sorted.end());
+                }
+
+                // The single nearest of the tree itself.
+                if (k == 1) {
+                    for (std::size_t q = 0; q != query.size(); ++q)
+                        CORRADE_COMPARE(
+                            (input[tree.nearest(query[q])] - query[q]).dot(),
+                            (input[expected[q]] - query[q]).dot());
+                }
+            }
+        }
+    }
+}
+
+void KdTreeTest::withinRadius() {
+    auto&& data = InputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for (std::uint32_t seed = 0; seed != 5; ++seed) {
+        CORRADE_ITERATION(seed);
+        const std::vector<Vector2> input = points(data.input, seed);
+        const std::vector<Vector2> query = queries(input, seed);
+
+        // Radius 1 on the grid puts points exactly on the circle.
+        for (const float radius : {0.0f, 1.0f, 4.5f}) {
+            for (const unsigned threads : ThreadCounts) {
+                const KdTree2D tree{input, threads};
+                const RadiusQueryResults found =
+                    findPointsWithinRadius(tree, query, radius, threads);
+                CORRADE_COMPARE(found.offsets.size(), query.size() + 1);
+                CORRADE_COMPARE(found.offsets.back(), found.indices.size());
+
+                std::vector<std::uint32_t> sorted, expected;
+                for (std::size_t q = 0; q != query.size(); ++q) {
+                    sorted.assign(found.indices.begin() + found.offsets[q],
+                                  found.indices.begin() +
+                                      found.offsets[q + 1]);
+                    std::sort(sorted.begin(), sorted.end());
+                    expected.clear();
+                    for (std::uint32_t i = 0; i != input.size(); ++i) {
+                        if ((input[i] - query[q]).dot() <= radius * radius)
+                            expected.push_back(i);
+                    }
+                    CORRADE_VERIFY(sorted == expected);
+                    // Every input point is within radius 0 of itself.
+                    if (q < input.size())
+                        CORRADE_VERIFY(std::binary_search(
+                            sorted.begin(), sorted.end(), std::uint32_t(q)));
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+} // namespace Test
+} // namespace CompGeom
+
+CORRADE_TEST_MAIN(CompGeom::Test::KdTreeTest)
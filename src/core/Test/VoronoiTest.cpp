@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Magnum/Math/Functions.h>
+
+#include "core/CompGeomCore.h"
+#include "core/Predicates.h"
+
+namespace CompGeom {
+namespace Test {
+namespace {
+
+struct VoronoiTest : TestSuite::Tester {
+    explicit VoronoiTest();
+
+    void diagram();
+    void collinear();
+};
+
+enum class Input {
+    Random,     // Uniform sites.
+    IntegerGrid, // Part of a grid, four sites on most circles.
+    Cocircular, // Integer points on circles of radius 5 and 25.
+    SameX       // Columns of sites, the first column seeding the beach.
+};
+
+const struct {
+    const char* name;
+    Input input;
+} InputData[]{{"random", Input::Random},
+              {"integer grid", Input::IntegerGrid},
+              {"cocircular", Input::Cocircular},
+              {"same x", Input::SameX}};
+
+const SweepStatus Statuses[]{SweepStatus::Set, SweepStatus::ArenaSet,
+                             SweepStatus::SkipList};
+
+bool lexLess(const Vector2& a, const Vector2& b) {
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+}
+
+// Distinct sites in random order.
+std::vector<Vector2> sites(Input input, std::uint32_t seed) {
+    std::mt19937 random{seed};
+    std::vector<Vector2> out;
+    switch (input) {
+    case Input::Random:
+        out.resize(300);
+        generatePoints(out, PointDistribution::Uniform, seed, 1000.0f, 1);
+        break;
+    case Input::IntegerGrid: {
+        std::bernoulli_distribution keep{0.7};
+        for (int x = 0; x != 12; ++x) {
+            for (int y = 0; y != 10; ++y) {
+                if (keep(random))
+                    out.emplace_back(float(x), float(y));
+            }
+        }
+        break;
+    }
+    case Input::Cocircular: {
+        // x^2 + y^2 = 25 and 625 in integers.
+        const std::pair<int, int> onCircle[]{
+            {5, 0}, {4, 3}, {3, 4}, {25, 0}, {24, 7}, {20, 15}, {15, 20},
+            {7, 24}};
+        std::bernoulli_distribution keep{0.8};
+        for (const std::pair<int, int>& p : onCircle) {
+            for (const Vector2 sign :
+                 {Vector2{1.0f, 1.0f}, Vector2{-1.0f, 1.0f},
+                  Vector2{1.0f, -1.0f}, Vector2{-1.0f, -1.0f}}) {
+                if (keep(random)) {
+                    out.push_back(sign * Vector2{float(p.first),
+                                                 float(p.second)});
+                    out.push_back(sign * Vector2{float(p.second),
+                                                 float(p.first)});
+                }
+            }
+        }
+        out.emplace_back(0.0f, 0.0f);
+        break;
+    }
+    case Input::SameX: {
+        std::uniform_int_distribution<int> y{0, 40};
+        for (int column = 0; column != 6; ++column) {
+            for (int i = 0; i != 8; ++i)
+                out.emplace_back(float(column * 3), float(y(random)));
+        }
+        break;
+    }
+    }
+    std::sort(out.begin(), out.end(), lexLess);
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    std::shuffle(out.begin(), out.end(), random);
+    return out;
+}
+
+typedef std::set<std::pair<std::uint32_t, std::uint32_t>> EdgeSet;
+
+std::pair<std::uint32_t, std::uint32_t> edge(std::uint32_t a,
+                                             std::uint32_t b) {
+    return {std::min(a, b), std::max(a, b)};
+}
+
+VoronoiTest::VoronoiTest() {
+    addInstancedTests({&VoronoiTest::diagram},
+                      Containers::arraySize(InputData));
+    addTests({&VoronoiTest::collinear});
+}
+
+void VoronoiTest::diagram() {
+    auto&& data = InputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for (std::uint32_t seed = 0; seed != 10; ++seed) {
+        CORRADE_ITERATION(seed);
+        const std::vector<Vector2> input = sites(data.input, seed);
+        const DelaunayTriangulation delaunay =
+            computeDelaunayTriangulation(input);
+        const std::vector<std::uint32_t>& t = delaunay.triangles;
+        CORRADE_VERIFY(delaunay.size() > 0);
+
+        for (const SweepStatus status : Statuses) {
+            const VoronoiDiagram voronoi =
+                computeVoronoiDiagram(input, status);
+            CORRADE_COMPARE(voronoi.cellOffsets.size(), input.size() + 1);
+
+            // A finite vertex is the centre of an empty circle through the
+            // two sites of the edge, up to the rounding to float.
+            for (std::size_t e = 0; e != voronoi.edgeCount(); ++e) {
+                const Vector2d a{input[voronoi.edgeSites[2 * e]]};
+                const Vector2d b{input[voronoi.edgeSites[2 * e + 1]]};
+                for (int end = 0; end != 2; ++end) {
+                    const std::uint32_t v = voronoi.edgeVertices[2 * e + end];
+                    if (v == VoronoiInfinity)
+                        continue;
+                    CORRADE_VERIFY(v < voronoi.vertices.size());
+                    const Vector2d p{voronoi.vertices[v]};
+                    const double tolerance =
+                        1.0e-5 * Math::max(1.0, p.length());
+                    const double radius = (p - a).length();
+                    CORRADE_VERIFY(Math::abs((p - b).length() - radius) <=
+                                   tolerance);
+                    for (const Vector2& site : input)
+                        CORRADE_VERIFY((p - Vector2d{site}).length() >=
+                                       radius - tolerance);
+                }
+            }
+
+            // Edges of positive length, keyed by their sites. The zero
+            // length ones only split a vertex shared by four or more sites.
+            EdgeSet edges;
+            for (std::size_t e = 0; e != voronoi.edgeCount(); ++e) {
+                const std::uint32_t v0 = voronoi.edgeVertices[2 * e];
+                const std::uint32_t v1 = voronoi.edgeVertices[2 * e + 1];
+                if (v0 != VoronoiInfinity && v1 != VoronoiInfinity &&
+                    voronoi.vertices[v0] == voronoi.vertices[v1])
+                    continue;
+                edges.insert(edge(voronoi.edgeSites[2 * e],
+                                  voronoi.edgeSites[2 * e + 1]));
+            }
+
+            // Every cell edge has the site on one of its sides, and every
+            // edge is in the cells on both.
+            std::vector<int> cellsOfEdge(voronoi.edgeCount());
+            for (std::uint32_t site = 0; site != input.size(); ++site) {
+                for (std::uint32_t i = voronoi.cellOffsets[site];
+                     i != voronoi.cellOffsets[site + 1]; ++i) {
+                    const std::uint32_t e = voronoi.cellEdges[i];
+                    CORRADE_VERIFY(voronoi.edgeSites[2 * e] == site ||
+                                   voronoi.edgeSites[2 * e + 1] == site);
+                    ++cellsOfEdge[e];
+                }
+            }
+            for (const int cells : cellsOfEdge)
+                CORRADE_COMPARE(cells, 2);
+
+            // The Delaunay edges are the dual of the Voronoi edges. Where
+            // four or more sites are cocircular the triangulation picks
+            // diagonals that have no Voronoi edge of positive length.
+            EdgeSet dual;
+            for (std::size_t a = 0; a != delaunay.size(); ++a) {
+                for (int i = 0; i != 3; ++i) {
+                    const std::uint32_t from = t[3 * a + (i + 1) % 3];
+                    const std::uint32_t to = t[3 * a + (i + 2) % 3];
+                    dual.insert(edge(from, to));
+                    if (edges.count(edge(from, to)))
+                        continue;
+                    const std::uint32_t b = delaunay.neighbours[3 * a + i];
+                    CORRADE_VERIFY(b != DelaunayNoNeighbour);
+                    int j = 0;
+                    while (j != 3 && delaunay.neighbours[3 * b + j] != a)
+                        ++j;
+                    CORRADE_VERIFY(j != 3);
+                    CORRADE_COMPARE(incircle(input[t[3 * a]],
+                                             input[t[3 * a + 1]],
+                                             input[t[3 * a + 2]],
+                                             input[t[3 * b + j]]),
+                                    0.0);
+                }
+            }
+            for (const std::pair<std::uint32_t, std::uint32_t>& e : edges)
+                CORRADE_VERIFY(dual.count(e));
+        }
+    }
+}
+
+// No Delaunay triangles, the cells are strips between neighbours on the
+// line.
+void VoronoiTest::collinear() {
+    std::vector<Vector2> input;
+    for (int i = 0; i != 20; ++i)
+        input.emplace_back(float(i * 7 % 20), 3.0f);
+    for (int i = 0; i != 20; ++i)
+        input.emplace_back(-2.0f, float(i * 7 % 20));
+
+    for (const std::size_t offset : {std::size_t(0), std::size_t(20)}) {
+        const Containers::ArrayView<const Vector2> line{input.data() + offset,
+                                                        20};
+        for (const SweepStatus status : Statuses) {
+            const VoronoiDiagram voronoi = computeVoronoiDiagram(line, status);
+            CORRADE_COMPARE(voronoi.vertices.size(), std::size_t(0));
+            EdgeSet edges, expected;
+            for (std::size_t e = 0; e != voronoi.edgeCount(); ++e)
+                edges.insert(edge(voronoi.edgeSites[2 * e],
+                                  voronoi.edgeSites[2 * e + 1]));
+            for (std::uint32_t a = 0; a != 20; ++a) {
+                for (std::uint32_t b = 0; b != 20; ++b) {
+                    if ((line[b] - line[a]).dot() == 1.0f)
+                        expected.insert(edge(a, b));
+                }
+            }
+            CORRADE_COMPARE(voronoi.edgeCount(), std::size_t(19));
+            CORRADE_VERIFY(edges == expected);
+        }
+    }
+}
+
+} // namespace
+} // namespace Test
+} // namespace CompGeom
+
+CORRADE_TEST_MAIN(CompGeom::Test::VoronoiTest)
@@ -0,0 +1,14 @@
+#ifndef COMP_GEOM_CORE_TYPES_H
+#define COMP_GEOM_CORE_TYPES_H
+
+#include <Magnum/Magnum.h>
+
+// Everything of the project lives in CompGeom. The algorithms work on
+// Magnum's math types, so those are visible in it unqualified.
+namespace CompGeom {
+
+using namespace Magnum;
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,427 @@
+#include "core/Voronoi.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include <Magnum/Math/Functions.h>
+
+#include "core/Predicates.h"
+#include "core/SweepStatus.h"
+
+namespace CompGeom {
+
+namespace {
+
+constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+bool lexLess(const Vector2& lhs, const Vector2& rhs) {
+    return lhs.x() < rhs.x() || (lhs.x() == rhs.x() && lhs.y() < rhs.y());
+}
+
+// Monotonic in the angle of d, without the atan2.
+double pseudoAngle(const Vector2d& d) {
+    const double p = d.y() / (Math::abs(d.x()) + Math::abs(d.y()));
+    if (d.x() < 0.0)
+        return 2.0 - p;
+    return d.y() < 0.0 ? 4.0 + p : p;
+}
+
+// A parabolic arc of the beach line, with the sites of the arcs below and
+// above it (-1 at the ends), the edge its upper breakpoint traces and the
+// version of its pending circle event.
+struct Arc {
+    int site;
+    int below, above;
+    std::uint32_t edgeAbove;
+    std::uint32_t event;
+};
+
+// Vanishing of an arc, at the sweep position x where the circle through its
+// site and its neighbours' is left behind.
+struct CircleEvent {
+    double x, y;
+    Vector2d center;
+    int arc;
+    std::uint32_t version;
+
+    bool operator>(const CircleEvent& other) const {
+        return x > other.x || (x == other.x && y > other.y);
+    }
+};
+
+// Arc geometry and the beach line order at the sweep line, so it can be
+// kept in any of the sweep status structures.
+class Beach {
+  public:
+    explicit Beach(Containers::ArrayView<const Vector2> sites)
+        : sites_(sites) {}
+
+    // Arcs ordered by their upper end, then their lower end so an arc that
+    // was just born between two others sorts between them. The probe stands
+    // for the height of the site being inserted.
+    bool less(int a, int b) const {
+        if (a == b)
+            return false;
+        if (b == ProbeArc)
+            return upperEnd(a) < probeY_;
+        if (a == ProbeArc)
+            return probeY_ < lowerEnd(b);
+        const double upperA = upperEnd(a), upperB = upperEnd(b);
+        if (upperA != upperB)
+            return upperA < upperB;
+        return lowerEnd(a) < lowerEnd(b);
+    }
+
+    static constexpr int ProbeArc = -1;
+
+  protected:
+    Vector2d site(int index) const { return Vector2d{sites_[index]}; }
+
+    // Height of the breakpoint between the arcs of site lower, below, and
+    // upper, above, on the sweep line.
+    double breakpoint(int lower, int upper) const {
+        const Vector2d l = site(lower), u = site(upper);
+        const double dl = l.x() - sweepX_, du = u.x() - sweepX_;
+        // Sites on the sweep line have a horizontal ray as their arc.
+        if (dl == 0.0 && du == 0.0)
+            return 0.5 * (l.y() + u.y());
+        if (dl == 0.0)
+            return l.y();
+        if (du == 0.0)
+            return u.y();
+        // The root of du (y - l.y)^2 - dl (y - u.y)^2 = dl du (du - dl)
+        // where the arc of lower gives way to the arc of upper, in the form
+        // that doesn't cancel.
+        const double e = u.y() - l.y();
+        const double root =
+            std::sqrt(dl * du * (e * e + (dl - du) * (dl - du)));
+        if (dl * e > 0.0)
+            return l.y() + (dl * e + root) / (dl - du);
+        return l.y() + dl * (du * (dl - du) - e * e) / (root - dl * e);
+    }
+
+    double lowerEnd(int arc) const {
+        const Arc& a = arcs_[arc];
+        return a.below < 0 ? -Infinity : breakpoint(a.below, a.site);
+    }
+
+    double upperEnd(int arc) const {
+        const Arc& a = arcs_[arc];
+        return a.above < 0 ? Infinity : breakpoint(a.site, a.above);
+    }
+
+    // Where the arc of site index is at height y.
+    double beachX(int index, double y) const {
+        const Vector2d s = site(index);
+        const double d = s.x() - sweepX_;
+        if (d == 0.0)
+            return s.x();
+        return (y - s.y()) * (y - s.y()) / (2.0 * d) + 0.5 * (s.x() + sweepX_);
+    }
+
+    Containers::ArrayView<const Vector2> sites_;
+    std::vector<Arc> arcs_;
+    double sweepX_ = -Infinity;
+    double probeY_ = 0.0;
+};
+
+// Orders the beach line at the sweep line.
+struct BeachLess {
+    const Beach* beach;
+    bool operator()(int a, int b) const { return beach->less(a, b); }
+};
+
+template <class Status> class Fortune : public Beach {
+  public:
+    explicit Fortune(Containers::ArrayView<const Vector2> sites)
+        : Beach(sites), status_(2 * sites.size(), BeachLess{this}) {
+        arcs_.reserve(2 * sites.size());
+    }
+
+    // Sweeps the sites, given sorted by x then y without duplicates.
+    void run(const std::vector<int>& order, VoronoiDiagram& out) {
+        out_ = &out;
+        if (order.empty())
+            return;
+
+        // Sites sharing the smallest x have no arc to split, they stack up
+        // with horizontal edges between them.
+        std::size_t next = 0;
+        sweepX_ = sites_[order[0]].x();
+        for (; next != order.size() && site(order[next]).x() == sweepX_;
+             ++next) {
+            const int s = order[next];
+            const int arc = newArc(s, next == 0 ? -1 : order[next - 1], -1);
+            if (next != 0) {
+                Arc& below = arcs_[arc - 1];
+                below.above = s;
+                below.edgeAbove = newEdge(s, below.site);
+            }
+            status_.insert(arc);
+        }
+
+        while (next != order.size() || !events_.empty()) {
+            // Circle events go first on ties.
+            bool isSite = next != order.size();
+            if (isSite && !events_.empty()) {
+                const Vector2d p = site(order[next]);
+                const CircleEvent& event = events_.top();
+                isSite = p.x() < event.x ||
+                         (p.x() == event.x && p.y() < event.y);
+            }
+            if (isSite)
+                insertSite(order[next++]);
+            else {
+                const CircleEvent event = events_.top();
+                events_.pop();
+                if (arcs_[event.arc].event == event.version)
+                    removeArc(event);
+            }
+        }
+    }
+
+  private:
+    int newArc(int site, int below, int above) {
+        arcs_.push_back({site, below, above, VoronoiInfinity, 0});
+        return int(arcs_.size() - 1);
+    }
+
+    std::uint32_t newEdge(int left, int right,
+                          std::uint32_t first = VoronoiInfinity) {
+        out_->edgeSites.push_back(std::uint32_t(left));
+        out_->edgeSites.push_back(std::uint32_t(right));
+        out_->edgeVertices.push_back(first);
+        out_->edgeVertices.push_back(VoronoiInfinity);
+        return std::uint32_t(out_->edgeSites.size() / 2 - 1);
+    }
+
+    std::uint32_t newVertex(const Vector2d& position) {
+        out_->vertices.push_back(Vector2{position});
+        return std::uint32_t(out_->vertices.size() - 1);
+    }
+
+    // Ends the edge traced by the breakpoint between the arcs of lower and
+    // upper at vertex. The breakpoint moves with upper on its left, so that
+    // is the second vertex if upper is the edge's left site.
+    void finishEdge(std::uint32_t edge, int upper, std::uint32_t vertex) {
+        const bool forward = out_->edgeSites[2 * edge] == std::uint32_t(upper);
+        out_->edgeVertices[2 * edge + (forward ? 1 : 0)] = vertex;
+    }
+
+    void insertSite(int s) {
+        const Vector2d p = site(s);
+        sweepX_ = p.x();
+        probeY_ = p.y();
+        int a = status_.lowerBound(ProbeArc);
+        if (a == StatusEnd)
+            a = status_.prev(StatusEnd);
+        const int b = status_.next(a);
+
+        // Exactly below a breakpoint, the new arc goes between the two arcs
+        // and their edge ends right there.
+        if (b != StatusEnd && upperEnd(a) == p.y()) {
+            const std::uint32_t vertex =
+                newVertex({beachX(arcs_[a].site, p.y()), p.y()});
+            finishEdge(arcs_[a].edgeAbove, arcs_[b].site, vertex);
+            const int n = newArc(s, arcs_[a].site, arcs_[b].site);
+            arcs_[n].edgeAbove = newEdge(arcs_[b].site, s, vertex);
+            arcs_[a].above = s;
+            arcs_[a].edgeAbove = newEdge(s, arcs_[a].site, vertex);
+            arcs_[b].below = s;
+            status_.insert(n);
+            checkCircle(a);
+            checkCircle(n);
+            checkCircle(b);
+            return;
+        }
+
+        // Split the arc: the lower part keeps its index, the new arc and
+        // the upper part are inserted above it.
+        const int upper = newArc(arcs_[a].site, s, arcs_[a].above);
+        arcs_[upper].edgeAbove = arcs_[a].edgeAbove;
+        const int n = newArc(s, arcs_[a].site, arcs_[a].site);
+        const std::uint32_t edge = newEdge(s, arcs_[a].site);
+        arcs_[n].edgeAbove = edge;
+        arcs_[a].above = s;
+        arcs_[a].edgeAbove = edge;
+        status_.insert(n);
+        status_.insert(upper);
+        checkCircle(a);
+        checkCircle(upper);
+    }
+
+    void removeArc(const CircleEvent& event) {
+        const int m = event.arc;
+        const int l = status_.prev(m), u = status_.next(m);
+        sweepX_ = std::max(sweepX_, event.x);
+        const std::uint32_t vertex = newVertex(event.center);
+        finishEdge(arcs_[l].edgeAbove, arcs_[m].site, vertex);
+        finishEdge(arcs_[m].edgeAbove, arcs_[u].site, vertex);
+        status_.erase(m);
+        ++arcs_[m].event;
+        arcs_[l].above = arcs_[u].site;
+        arcs_[l].edgeAbove = newEdge(arcs_[u].site, arcs_[l].site, vertex);
+        arcs_[u].below = arcs_[l].site;
+        checkCircle(l);
+        checkCircle(u);
+    }
+
+    // Queues the vanishing of the arc if its breakpoints converge, i.e. its
+    // neighbours' sites turn clockwise around its own. Any event queued
+    // before for it is stale from now on.
+    void checkCircle(int arc) {
+        Arc& m = arcs_[arc];
+        ++m.event;
+        if (m.below < 0 || m.above < 0)
+            return;
+        const Vector2d a = site(m.below), b = site(m.site), c = site(m.above);
+        if (orient2d(a, b, c) >= 0.0)
+            return;
+        const Vector2d ba = b - a, ca = c - a;
+        const double d = 2.0 * Math::cross(ba, ca);
+        const Vector2d center =
+            a + Vector2d{ca.y() * ba.dot() - ba.y() * ca.dot(),
+                         ba.x() * ca.dot() - ca.x() * ba.dot()} /
+                    d;
+        const double x = std::max(center.x() + (b - center).length(), sweepX_);
+        events_.push({x, center.y(), center, arc, m.event});
+    }
+
+    Status status_;
+    std::priority_queue<CircleEvent, std::vector<CircleEvent>,
+                        std::greater<CircleEvent>>
+        events_;
+    VoronoiDiagram* out_ = nullptr;
+};
+
+template <class Status>
+void runFortune(Containers::ArrayView<const Vector2> sites,
+                const std::vector<int>& order, VoronoiDiagram& out) {
+    Fortune<Status> fortune{sites};
+    fortune.run(order, out);
+}
+
+// Orders the edges of every cell counterclockwise. Each edge lies on the
+// bisector with the site across it, so the direction to that site orders
+// them.
+void buildCells(Containers::ArrayView<const Vector2> sites,
+                VoronoiDiagram& out) {
+    out.cellOffsets.assign(sites.size() + 1, 0);
+    for (std::uint32_t site : out.edgeSites)
+        ++out.cellOffsets[site + 1];
+    for (std::size_t i = 0; i != sites.size(); ++i)
+        out.cellOffsets[i + 1] += out.cellOffsets[i];
+    out.cellEdges.resize(out.edgeSites.size());
+    std::vector<std::uint32_t> fill(out.cellOffsets.begin(),
+                                    out.cellOffsets.end() - 1);
+    for (std::size_t i = 0; i != out.edgeSites.size(); ++i)
+        out.cellEdges[fill[out.edgeSites[i]]++] = std::uint32_t(i / 2);
+
+    std::vector<std::pair<double, std::uint32_t>> sorted;
+    for (std::size_t s = 0; s != sites.size(); ++s) {
+        const std::uint32_t begin = out.cellOffsets[s];
+        const std::uint32_t end = out.cellOffsets[s + 1];
+        sorted.clear();
+        for (std::uint32_t i = begin; i != end; ++i) {
+            const std::uint32_t edge = out.cellEdges[i];
+            const std::uint32_t* across = &out.edgeSites[2 * edge];
+            const std::uint32_t other = across[0] == s ? across[1] : across[0];
+            sorted.emplace_back(
+                pseudoAngle(Vector2d{sites[other]} - Vector2d{sites[s]}),
+                edge);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        for (std::uint32_t i = begin; i != end; ++i)
+            out.cellEdges[i] = sorted[i - begin].second;
+    }
+}
+
+} // namespace
+
+VoronoiDiagram computeVoronoiDiagram(Containers::ArrayView<const Vector2> sites,
+                                     SweepStatus status) {
+    // Site events in the order of the segment sweep's event queue.
+    std::vector<int> order(sites.size());
+    for (std::size_t i = 0; i != sites.size(); ++i)
+        order[i] = int(i);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return lexLess(sites[a], sites[b]) || (sites[a] == sites[b] && a < b);
+    });
+    order.erase(std::unique(order.begin(), order.end(),
+                            [&](int a, int b) { return sites[a] == sites[b]; }),
+                order.end());
+
+    VoronoiDiagram out;
+    switch (status) {
+    case SweepStatus::Set:
+        runFortune<SetStatus<BeachLess>>(sites, order, out);
+        break;
+    case SweepStatus::ArenaSet:
+        runFortune<ArenaSetStatus<BeachLess>>(sites, order, out);
+        break;
+    case SweepStatus::SkipList:
+        runFortune<SkipListStatus<BeachLess>>(sites, order, out);
+        break;
+    }
+    buildCells(sites, out);
+    return out;
+}
+
+std::vector<Seg2>
+voronoiEdgeSegments(const VoronoiDiagram& diagram,
+                    Containers::ArrayView<const Vector2> sites,
+                    const Vector2& min, const Vector2& max) {
+    std::vector<Seg2> segs;
+    segs.reserve(diagram.edgeCount());
+    for (std::size_t e = 0; e != diagram.edgeCount(); ++e) {
+        const Vector2d left{sites[diagram.edgeSites[2 * e]]};
+        const Vector2d right{sites[diagram.edgeSites[2 * e + 1]]};
+        const Vector2d w = right - left;
+        const Vector2d direction{-w.y(), w.x()};
+        const std::uint32_t first = diagram.edgeVertices[2 * e];
+        const std::uint32_t second = diagram.edgeVertices[2 * e + 1];
+
+        // The edge as origin + t direction for t in [t0, t1].
+        Vector2d origin = (left + right) * 0.5;
+        double t0 = -Infinity, t1 = Infinity;
+        if (first != VoronoiInfinity) {
+            origin = Vector2d{diagram.vertices[first]};
+            t0 = 0.0;
+            if (second != VoronoiInfinity)
+                t1 = 1.0;
+        } else if (second != VoronoiInfinity) {
+            origin = Vector2d{diagram.vertices[second]};
+            t1 = 0.0;
+        }
+        const bool bounded =
+            first != VoronoiInfinity && second != VoronoiInfinity;
+        const Vector2d end =
+            bounded ? Vector2d{diagram.vertices[second]} - origin : direction;
+
+        // Liang-Barsky against the box.
+        bool inside = true;
+        for (int axis = 0; axis != 2 && inside; ++axis) {
+            const double lo = min[axis], hi = max[axis];
+            if (end[axis] == 0.0) {
+                inside = origin[axis] >= lo && origin[axis] <= hi;
+                continue;
+            }
+            double a = (lo - origin[axis]) / end[axis];
+            double b = (hi - origin[axis]) / end[axis];
+            if (a > b)
+                std::swap(a, b);
+            t0 = std::max(t0, a);
+            t1 = std::min(t1, b);
+            inside = t0 <= t1;
+        }
+        if (inside)
+            segs.emplace_back(Vector2{origin + end * t0},
+                              Vector2{origin + end * t1});
+    }
+    return segs;
+}
+
+} // namespace CompGeom
@@ -0,0 +1,58 @@
+#ifndef COMP_GEOM_CORE_VORONOI_H
+#define COMP_GEOM_CORE_VORONOI_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "core/BentleyOttmann.h"
+#include "core/Seg2.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// End of an unbounded Voronoi edge.
+constexpr std::uint32_t VoronoiInfinity = 0xffffffffu;
+
+// Voronoi diagram as flat index arrays, nothing allocated per cell.
+struct VoronoiDiagram {
+    std::vector<Vector2> vertices;
+    // Two entries per edge: the sites to its left and right, looking from
+    // its first vertex to its second.
+    std::vector<std::uint32_t> edgeSites;
+    // Two entries per edge: its first and second vertex, VoronoiInfinity
+    // where it is unbounded. An unbounded end lies in the direction with
+    // the left site on the left, or the opposite one for the first vertex.
+    std::vector<std::uint32_t> edgeVertices;
+    // The edges of the cell of site i are cellEdges[cellOffsets[i]] up to
+    // cellEdges[cellOffsets[i + 1]], counterclockwise around the site.
+    std::vector<std::uint32_t> cellOffsets;
+    std::vector<std::uint32_t> cellEdges;
+
+    std::size_t edgeCount() const { return edgeSites.size() / 2; }
+};
+
+// Fortune's sweep. Events are ordered by x then y as in the segment sweep,
+// and the beach line of parabolic arcs is kept in the same status
+// structures (see core/SweepStatus.h), ordered by height. Duplicate sites
+// get an empty cell. At most 2^31 - 1 sites.
+VoronoiDiagram
+computeVoronoiDiagram(Containers::ArrayView<const Vector2> sites,
+                      SweepStatus status = SweepStatus::SkipList);
+
+// The edges as segments, e.g. for CompGeom::renderSegs2(), clipped to the
+// box from min to max, which also cuts off the unbounded ones. Edges
+// outside the box are left out.
+std::vector<Seg2>
+voronoiEdgeSegments(const VoronoiDiagram& diagram,
+                    Containers::ArrayView<const Vector2> sites,
+                    const Vector2& min, const Vector2& max);
+
+} // namespace CompGeom
+
+#endif
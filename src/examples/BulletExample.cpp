@@ -29,10 +29,12 @@
     CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include <chrono>
 #include <btBulletDynamicsCommon.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pointer.h>
+#include <Corrade/Utility/Arguments.h>
 #include <Magnum/Timeline.h>
 #include <Magnum/BulletIntegration/Integration.h>
 #include <Magnum/BulletIntegration/MotionState.h>
@@ -54,6 +56,8 @@
 #include <Magnum/Shaders/Phong.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "BulletWorld.h"
+
 namespace Magnum { namespace Examples {
 
 using namespace Math::Literals;
@@ -82,14 +86,11 @@ class BulletExample: public Platform::Application {
         BulletIntegration::DebugDraw _debugDraw{NoCreate};
         Containers::Array<InstanceData> _boxInstanceData, _sphereInstanceData;
 
-        btDbvtBroadphase _bBroadphase;
-        btDefaultCollisionConfiguration _bCollisionConfig;
-        btCollisionDispatcher _bDispatcher{&_bCollisionConfig};
-        btSequentialImpulseConstraintSolver _bSolver;
-
         /* The world has to live longer than the scene because RigidBody
            instances have to remove themselves from it on destruction */
-        btDiscreteDynamicsWorld _bWorld{&_bDispatcher, &_bBroadphase, &_bSolver, &_bCollisionConfig};
+        Containers::Pointer<BulletWorld> _bullet;
+        btDiscreteDynamicsWorld* _bWorld{};
+        btITaskScheduler* _bTaskScheduler{};
 
         Scene3D _scene;
         SceneGraph::Camera3D* _camera;
@@ -100,9 +101,15 @@ class BulletExample: public Platform::Application {
 
         btBoxShape _bBoxShape{{0.5f, 0.5f, 0.5f}};
         btSphereShape _bSphereShape{0.25f};
-        btBoxShape _bGroundShape{{4.0f, 0.5f, 4.0f}};
+        Containers::Pointer<btBoxShape> _bGroundShape;
 
         bool _drawCubes{true}, _drawDebug{true}, _shootBox{true};
+
+        /* Step time, averaged and printed every StepReportFrames frames */
+        enum: Int { StepReportFrames = 60 };
+        std::chrono::steady_clock::duration _stepTime{};
+        Int _steppedFrames{};
+        Float _sceneScale{1.0f};
 };
 
 class ColoredDrawable: public SceneGraph::Drawable3D {
@@ -155,6 +162,27 @@ class RigidBody: public Object3D {
 };
 
 BulletExample::BulletExample(const Arguments& arguments): Platform::Application(arguments, NoCreate) {
+    Utility::Arguments args;
+    args.addOption("threads", "0")
+            .setHelp("threads", "step on btDiscreteDynamicsWorldMt with this many threads, 0 for the single-threaded world", "N")
+        .addOption("scheduler", "default")
+            .setHelp("scheduler", "task scheduler for the threads: default, openmp, tbb or ppl")
+        .addOption("stack", "5")
+            .setHelp("stack", "side of the stack of boxes", "N")
+        .addSkippedPrefix("magnum", "engine-specific options")
+        .setGlobalHelp("Bullet integration example. With --threads the average step time is printed\n"
+            "every second, + and - change the thread count while running.")
+        .parse(arguments.argc, arguments.argv);
+    const Int stack = Math::max(1, args.value<Int>("stack"));
+    _sceneScale = boxStackScale(stack);
+
+    /* Bullet setup */
+    _bullet.reset(new BulletWorld{args.value<Int>("threads"), args.value("scheduler")});
+    _bWorld = &_bullet->world();
+    _bTaskScheduler = _bullet->taskScheduler();
+    if(_bTaskScheduler)
+        Debug{} << "Stepping on" << _bTaskScheduler->getName() << "with" << _bTaskScheduler->getNumThreads() << "threads";
+
     /* Try 8x MSAA, fall back to zero samples if not possible. Enable only 2x
        MSAA if we have enough DPI. */
     {
@@ -170,14 +198,14 @@ BulletExample::BulletExample(const Arguments& arguments): Platform::Application(
 
     /* Camera setup */
     (*(_cameraRig = new Object3D{&_scene}))
-        .translate(Vector3::yAxis(3.0f))
+        .translate(Vector3::yAxis(3.0f*_sceneScale))
         .rotateY(40.0_degf);
     (*(_cameraObject = new Object3D{_cameraRig}))
-        .translate(Vector3::zAxis(20.0f))
+        .translate(Vector3::zAxis(20.0f*_sceneScale))
         .rotateX(-25.0_degf);
     (_camera = new SceneGraph::Camera3D(*_cameraObject))
         ->setAspectRatioPolicy(SceneGraph::AspectRatioPolicy::Extend)
-        .setProjectionMatrix(Matrix4::perspectiveProjection(35.0_degf, 1.0f, 0.001f, 100.0f))
+        .setProjectionMatrix(Matrix4::perspectiveProjection(35.0_degf, 1.0f, 0.001f, 100.0f*_sceneScale))
         .setViewport(GL::defaultFramebuffer.viewport().size());
 
     /* Create an instanced shader */
@@ -208,24 +236,25 @@ BulletExample::BulletExample(const Arguments& arguments): Platform::Application(
     GL::Renderer::enable(GL::Renderer::Feature::PolygonOffsetFill);
     GL::Renderer::setPolygonOffset(2.0f, 0.5f);
 
-    /* Bullet setup */
+    /* Debug draw setup */
     _debugDraw = BulletIntegration::DebugDraw{};
     _debugDraw.setMode(BulletIntegration::DebugDraw::Mode::DrawWireframe);
-    _bWorld.setGravity({0.0f, -10.0f, 0.0f});
-    _bWorld.setDebugDrawer(&_debugDraw);
+    _bWorld->setDebugDrawer(&_debugDraw);
 
-    /* Create the ground */
-    auto* ground = new RigidBody{&_scene, 0.0f, &_bGroundShape, _bWorld};
+    /* Create the ground, large enough for the stack */
+    const Vector3 groundSize = boxStackGroundHalfSize(stack);
+    _bGroundShape.reset(new btBoxShape{btVector3{groundSize}});
+    auto* ground = new RigidBody{&_scene, 0.0f, _bGroundShape.get(), *_bWorld};
     new ColoredDrawable{*ground, _boxInstanceData, 0xffffff_rgbf,
-        Matrix4::scaling({4.0f, 0.5f, 4.0f}), _drawables};
+        Matrix4::scaling(groundSize), _drawables};
 
     /* Create boxes with random colors */
     Deg hue = 42.0_degf;
-    for(Int i = 0; i != 5; ++i) {
-        for(Int j = 0; j != 5; ++j) {
-            for(Int k = 0; k != 5; ++k) {
-                auto* o = new RigidBody{&_scene, 1.0f, &_bBoxShape, _bWorld};
-                o->translate({i - 2.0f, j + 4.0f, k - 2.0f});
+    for(Int i = 0; i != stack; ++i) {
+        for(Int j = 0; j != stack; ++j) {
+            for(Int k = 0; k != stack; ++k) {
+                auto* o = new RigidBody{&_scene, 1.0f, &_bBoxShape, *_bWorld};
+                o->translate(boxStackPosition(stack, i, j, k));
                 o->syncPose();
                 new ColoredDrawable{*o, _boxInstanceData,
                     Color3::fromHsv({hue += 137.5_degf, 0.75f, 0.9f}),
@@ -247,14 +276,23 @@ void BulletExample::drawEvent() {
     for(Object3D* obj = _scene.children().first(); obj; )
     {
         Object3D* next = obj->nextSibling();
-        if(obj->transformation().translation().dot() > 100*100)
+        if(obj->transformation().translation().dot() > 100.0f*100.0f*_sceneScale*_sceneScale)
             delete obj;
 
         obj = next;
     }
 
     /* Step bullet simulation */
-    _bWorld.stepSimulation(_timeline.previousFrameDuration(), 5);
+    const auto stepStart = std::chrono::steady_clock::now();
+    _bWorld->stepSimulation(_timeline.previousFrameDuration(), 5);
+    _stepTime += std::chrono::steady_clock::now() - stepStart;
+    if(++_steppedFrames == StepReportFrames) {
+        Debug{} << "Step:" << std::chrono::duration<Float, std::milli>{_stepTime}.count()/StepReportFrames
+            << "ms for" << _bWorld->getNumCollisionObjects() << "bodies on"
+            << (_bTaskScheduler ? _bTaskScheduler->getNumThreads() : 1) << "threads";
+        _stepTime = {};
+        _steppedFrames = 0;
+    }
 
     if(_drawCubes) {
         /* Populate instance data with transformations and colors */
@@ -284,7 +322,7 @@ void BulletExample::drawEvent() {
 
         _debugDraw.setTransformationProjectionMatrix(
             _camera->projectionMatrix()*_camera->cameraMatrix());
-        _bWorld.debugDrawWorld();
+        _bWorld->debugDrawWorld();
 
         if(_drawCubes)
             GL::Renderer::setDepthFunction(GL::Renderer::DepthFunction::Less);
@@ -321,6 +359,13 @@ void BulletExample::keyPressEvent(KeyEvent& event) {
     /* What to shoot */
     } else if(event.key() == KeyEvent::Key::S) {
         _shootBox ^= true;
+
+    /* Thread count of the Mt world, up to the solver pool size. Plus needs
+       Shift on most layouts, so the key it shares with = counts as well. */
+    } else if(_bTaskScheduler && (event.key() == KeyEvent::Key::Plus || event.key() == KeyEvent::Key::Equal || event.key() == KeyEvent::Key::NumAdd)) {
+        _bTaskScheduler->setNumThreads(Math::min(_bTaskScheduler->getNumThreads() + 1, _bTaskScheduler->getMaxNumThreads()));
+    } else if(_bTaskScheduler && (event.key() == KeyEvent::Key::Minus || event.key() == KeyEvent::Key::NumSubtract)) {
+        _bTaskScheduler->setNumThreads(Math::max(_bTaskScheduler->getNumThreads() - 1, 1));
     } else return;
 
     event.setAccepted();
@@ -340,7 +385,7 @@ void BulletExample::mousePressEvent(MouseEvent& event) {
             &_scene,
             _shootBox ? 1.0f : 5.0f,
             _shootBox ? static_cast<btCollisionShape*>(&_bBoxShape) : &_bSphereShape,
-            _bWorld};
+            *_bWorld};
         object->translate(_cameraObject->absoluteTransformation().translation());
         /* Has to be done explicitly after the translate() above, as Magnum ->
            Bullet updates are implicitly done only for kinematic bodies */
@@ -0,0 +1,53 @@
+#include "BulletWorld.h"
+
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <Corrade/Utility/DebugStl.h>
+
+namespace Magnum { namespace Examples {
+
+namespace {
+
+/* Bullet task scheduler by name, nullptr if Bullet was built without it.
+   The default one is created here and owned by the caller, the others are
+   singletons. */
+btITaskScheduler* taskScheduler(const std::string& name, Containers::Pointer<btITaskScheduler>& owned) {
+    if(name == "default") {
+        owned.reset(btCreateDefaultTaskScheduler());
+        return owned.get();
+    }
+    if(name == "openmp") return btGetOpenMPTaskScheduler();
+    if(name == "tbb") return btGetTBBTaskScheduler();
+    if(name == "ppl") return btGetPPLTaskScheduler();
+    return nullptr;
+}
+
+}
+
+BulletWorld::BulletWorld(const Int threads, const std::string& scheduler) {
+    /* The Mt world needs the scheduler installed first */
+    if(threads > 0) {
+        _bTaskScheduler = taskScheduler(scheduler, _bOwnedTaskScheduler);
+        if(!_bTaskScheduler)
+            Fatal{} << "Task scheduler" << scheduler << "isn't available in this Bullet build";
+        _bTaskScheduler->setNumThreads(threads);
+        btSetTaskScheduler(_bTaskScheduler);
+
+        _bDispatcher.reset(new btCollisionDispatcherMt{&_bCollisionConfig});
+        _bSolverPool.reset(new btConstraintSolverPoolMt{_bTaskScheduler->getMaxNumThreads()});
+        _bSolver.reset(new btSequentialImpulseConstraintSolverMt);
+        _bWorld.reset(new btDiscreteDynamicsWorldMt{_bDispatcher.get(), &_bBroadphase, _bSolverPool.get(), _bSolver.get(), &_bCollisionConfig});
+    } else {
+        _bDispatcher.reset(new btCollisionDispatcher{&_bCollisionConfig});
+        _bSolver.reset(new btSequentialImpulseConstraintSolver);
+        _bWorld.reset(new btDiscreteDynamicsWorld{_bDispatcher.get(), &_bBroadphase, _bSolver.get(), &_bCollisionConfig});
+    }
+
+    _bWorld->setGravity({0.0f, -10.0f, 0.0f});
+}
+
+BulletWorld::~BulletWorld() {
+    if(_bTaskScheduler) btSetTaskScheduler(btGetSequentialTaskScheduler());
+}
+
+}}
@@ -0,0 +1,66 @@
+#ifndef COMP_GEOM_EXAMPLES_BULLETWORLD_H
+#define COMP_GEOM_EXAMPLES_BULLETWORLD_H
+
+#include <string>
+#include <btBulletDynamicsCommon.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <LinearMath/btThreads.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector3.h>
+
+namespace Magnum { namespace Examples {
+
+/* The Bullet world of the Bullet example, shared with the headless physics
+   benchmark. Needs no GL context. */
+class BulletWorld {
+    public:
+        /* The single-threaded world if threads is 0, otherwise
+           btDiscreteDynamicsWorldMt on the named task scheduler (default,
+           openmp, tbb or ppl) with a solver per thread it may run on. Exits
+           with a message if Bullet was built without that scheduler. */
+        explicit BulletWorld(Int threads = 0, const std::string& scheduler = "default");
+
+        /* Puts the sequential task scheduler back in place of its own, so
+           another world can be created after it */
+        ~BulletWorld();
+
+        btDiscreteDynamicsWorld& world() { return *_bWorld; }
+        btCollisionDispatcher& dispatcher() { return *_bDispatcher; }
+
+        /* nullptr for the single-threaded world */
+        btITaskScheduler* taskScheduler() { return _bTaskScheduler; }
+
+    private:
+        btDbvtBroadphase _bBroadphase;
+        btDefaultCollisionConfiguration _bCollisionConfig;
+
+        /* Either the single-threaded dispatcher, solver and world, or their
+           Mt variants with a pool of solvers running on the task scheduler */
+        Containers::Pointer<btITaskScheduler> _bOwnedTaskScheduler;
+        btITaskScheduler* _bTaskScheduler{};
+        Containers::Pointer<btCollisionDispatcher> _bDispatcher;
+        Containers::Pointer<btConstraintSolverPoolMt> _bSolverPool;
+        Containers::Pointer<btConstraintSolver> _bSolver;
+        Containers::Pointer<btDiscreteDynamicsWorld> _bWorld;
+};
+
+/* Layout of the stack of unit boxes with the given side. The ground and the
+   camera distance grow with it past the original 5x5x5 stack. */
+inline Float boxStackScale(Int stack) {
+    return Math::max(1.0f, stack/5.0f);
+}
+
+inline Vector3 boxStackGroundHalfSize(Int stack) {
+    return {4.0f*boxStackScale(stack), 0.5f, 4.0f*boxStackScale(stack)};
+}
+
+inline Vector3 boxStackPosition(Int stack, Int i, Int j, Int k) {
+    const Float offset = (stack - 1)/2.0f;
+    return {i - offset, j + 4.0f, k - offset};
+}
+
+}}
+
+#endif
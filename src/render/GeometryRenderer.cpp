@@ -0,0 +1,211 @@
+#include "render/GeometryRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Magnum/GL/Sampler.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/MeshTools/Compile.h>
+#include <Magnum/Primitives/Axis.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Primitives/Line.h>
+#include <Magnum/Primitives/Square.h>
+#include <Magnum/Trade/MeshData.h>
+
+namespace CompGeom {
+
+GeometryRenderer::GeometryRenderer(const Vector2i& viewportSize,
+                                   int gridHeight)
+    : viewportSize_{viewportSize}, gridHeight_{gridHeight},
+      textureShader_{Shaders::Flat3D::Flag::Textured},
+      instancedShader_{Shaders::Phong::Flag::VertexColor |
+                       Shaders::Phong::Flag::InstancedTransformation} {
+    // Initialise the meshes.
+    axis_ = MeshTools::compile(Primitives::axis3D());
+    quad_ = MeshTools::compile(
+        Primitives::squareSolid(Primitives::SquareFlag::TextureCoordinates));
+    point_ = MeshTools::compile(Primitives::squareSolid());
+    line_ = MeshTools::compile(Primitives::line3D());
+    point_.addVertexBufferInstanced(
+        pointInstanceBuffer_, 1, 0, Shaders::Phong::TransformationMatrix{},
+        Shaders::Phong::NormalMatrix{}, Shaders::Phong::Color3{});
+    line_.addVertexBufferInstanced(
+        lineInstanceBuffer_, 1, 0, Shaders::Phong::TransformationMatrix{},
+        Shaders::Phong::NormalMatrix{}, Shaders::Phong::Color3{});
+
+    // The instanced ambient color is multiplied by each instance's color.
+    shader_.setLightPositions({{7.0f, 5.0f, 2.5f, 0.0f}});
+    instancedShader_.setLightPositions({{7.0f, 5.0f, 2.5f, 0.0f}})
+        .setAmbientColor(Color3(1, 1, 1));
+
+    setView(Vector2{0.0f}, Vector2{float(gridHeight_)});
+}
+
+void GeometryRenderer::setView(const Vector2& min, const Vector2& max) {
+    const float aspectRatio = viewportSize_.aspectRatio();
+    const Vector2 size = Math::max(max - min, Vector2{1e-6f});
+    centre_ = (min + max) / 2.0f;
+    viewHeight_ = std::max(size.y(), size.x() / aspectRatio);
+
+    // A tenth of the height as margin, as the unit one around the grid.
+    const float margin = viewHeight_ / 10.0f;
+    viewSize_ =
+        Vector2{aspectRatio * viewHeight_ + margin, viewHeight_ + margin};
+    projection_ = Matrix4::orthographicProjection(viewSize_, -100.0f, 100.0f);
+    shader_.setProjectionMatrix(projection_);
+    instancedShader_.setProjectionMatrix(projection_);
+}
+
+void GeometryRenderer::renderAxis() {
+    shader_.setAmbientColor(Color3(1, 1, 1))
+        .setTransformationMatrix(
+            Matrix4::translation(toScene(Vector3{})) *
+            Matrix4::scaling(Vector3(viewHeight_ / 10.0f)))
+        .draw(axis_);
+}
+
+void GeometryRenderer::renderPoints(Containers::ArrayView<const Vector2> points,
+                                    const Color3& color) {
+    instances_.clear();
+    for (const Vector2& point : points)
+        addPointInstance(Vector3(point, 0.0f), viewHeight_ / 200.0f, color);
+    drawInstances(point_, pointInstanceBuffer_);
+}
+
+void GeometryRenderer::renderPoints(Containers::ArrayView<const Vector3> points,
+                                    const Color3& color) {
+    instances_.clear();
+    for (const Vector3& point : points)
+        addPointInstance(point, viewHeight_ / 200.0f, color);
+    drawInstances(point_, pointInstanceBuffer_);
+}
+
+void GeometryRenderer::renderPointsLod(
+    Containers::ArrayView<const Vector2> points, const DensityPyramid& density,
+    const Color3& color, std::size_t maxPoints) {
+    const Vector2 min = centre_ - viewSize_ / 2.0f;
+    const Vector2 max = centre_ + viewSize_ / 2.0f;
+    if (density.countInBox(min, max) <= maxPoints) {
+        visible_.clear();
+        density.pointsInBox(min, max, points, visible_);
+        if (visible_.size() <= maxPoints) {
+            visiblePoints_.clear();
+            for (const std::uint32_t i : visible_)
+                visiblePoints_.push_back(points[i]);
+            renderPoints(visiblePoints_, color);
+            return;
+        }
+    }
+
+    // The finest level whose cells are at least a pixel.
+    const float pixel = viewSize_.y() / float(viewportSize_.y());
+    std::size_t level = 0;
+    while (level + 1 < density.levelCount() && density.cellSize(level) < pixel)
+        ++level;
+
+    // Counts to intensities on a log scale, so sparse cells stay visible
+    // next to dense ones. The shader multiplies them by the color.
+    const Containers::ArrayView<const std::uint32_t> counts =
+        density.counts(level);
+    const float scale =
+        1.0f / std::log1p(float(std::max(1u, density.maxCount(level))));
+    std::vector<Color4ub> pixels(counts.size());
+    for (std::size_t i = 0; i != counts.size(); ++i) {
+        const auto value =
+            UnsignedByte(255.0f * std::log1p(float(counts[i])) * scale);
+        pixels[i] = Color4ub{value, value, value, value};
+    }
+    const Vector2i size{Int(density.side(level))};
+    densityTexture_ = GL::Texture2D{};
+    densityTexture_.setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setMagnificationFilter(GL::SamplerFilter::Nearest)
+        .setMinificationFilter(GL::SamplerFilter::Linear)
+        .setStorage(1, GL::TextureFormat::RGBA8, size)
+        .setSubImage(0, {},
+                     ImageView2D{PixelFormat::RGBA8Unorm, size,
+                                 Containers::arrayView(pixels)});
+
+    // The unit square spans [-1, 1], moved just behind the points.
+    const Vector2 half = (density.max() - density.min()) / 2.0f;
+    const Vector3 centre =
+        toScene(Vector3((density.min() + density.max()) / 2.0f, -1.0f));
+    textureShader_.setColor(color)
+        .bindTexture(densityTexture_)
+        .setTransformationProjectionMatrix(
+            projection_ * Matrix4::translation(centre) *
+            Matrix4::scaling(Vector3(half, 1.0f)))
+        .draw(quad_);
+}
+
+void GeometryRenderer::render2DGridOfPoints(int step) {
+    // Render grid points.
+    instances_.clear();
+    for (int i = 0; i <= gridHeight_; i += step) {
+        for (int j = 0; j <= gridHeight_; j += step) {
+            addPointInstance(Vector3(float(i), float(j), 0.0f),
+                             viewHeight_ / 50.0f,
+                             Color3(float(i) / float(gridHeight_),
+                                    float(j) / float(gridHeight_), 0));
+        }
+    }
+    drawInstances(point_, pointInstanceBuffer_);
+}
+
+void GeometryRenderer::renderPolyLine(
+    Containers::ArrayView<const Vector2> polyLine, const Color3& color) {
+    instances_.clear();
+    for (std::size_t i = 1; i < polyLine.size(); ++i)
+        addLineInstance(polyLine[i - 1], polyLine[i], color);
+    drawInstances(line_, lineInstanceBuffer_);
+}
+
+void GeometryRenderer::renderSegs2(Containers::ArrayView<const Seg2> segs,
+                                   const Color3& color) {
+    instances_.clear();
+    for (const Seg2& seg : segs)
+        addLineInstance(seg.p, seg.q, color);
+    drawInstances(line_, lineInstanceBuffer_);
+}
+
+// View coordinates to the scene, centred on the origin.
+Vector3 GeometryRenderer::toScene(const Vector3& point) const {
+    return point - Vector3(centre_, 0.0f);
+}
+
+void GeometryRenderer::addPointInstance(const Vector3& point, float scale,
+                                        const Color3& color) {
+    instances_.push_back({Matrix4::translation(toScene(point)) *
+                              Matrix4::scaling(Vector3(scale)),
+                          Matrix3x3{Math::IdentityInit}, color});
+}
+
+// The unit line along x rotated onto the segment and scaled to its length,
+// built directly instead of from a lookAt.
+void GeometryRenderer::addLineInstance(const Vector2& start,
+                                       const Vector2& end,
+                                       const Color3& color) {
+    const Vector2 d = end - start;
+    const float length = d.length();
+    const Vector2 x = length > 0.0f ? d / length : Vector2::xAxis();
+    const Matrix3x3 rotation{Vector3(x, 0.0f), Vector3(x.perpendicular(), 0.0f),
+                             Vector3::zAxis()};
+    instances_.push_back(
+        {Matrix4::from(rotation, toScene(Vector3(start, 0.0f))) *
+             Matrix4::scaling(Vector3(length)),
+         rotation, color});
+}
+
+// Uploads the collected instances, orphaning the previous contents, and
+// draws them all in one call.
+void GeometryRenderer::drawInstances(GL::Mesh& mesh, GL::Buffer& buffer) {
+    if (instances_.empty())
+        return;
+    buffer.setData(Containers::arrayView(instances_),
+                   GL::BufferUsage::DynamicDraw);
+    mesh.setInstanceCount(Int(instances_.size()));
+    instancedShader_.draw(mesh);
+}
+
+} // namespace CompGeom
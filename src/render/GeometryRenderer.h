@@ -0,0 +1,107 @@
+#ifndef COMP_GEOM_RENDER_GEOMETRYRENDERER_H
+#define COMP_GEOM_RENDER_GEOMETRYRENDERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Shaders/Flat.h>
+#include <Magnum/Shaders/Phong.h>
+
+#include "core/DensityPyramid.h"
+#include "core/Seg2.h"
+#include "core/Types.h"
+
+namespace CompGeom {
+
+// Visible points renderPointsLod() draws one by one at most, by default.
+// Fewer points than this in total don't need a DensityPyramid at all.
+constexpr std::size_t LodMaxPoints = 100000;
+
+// Draws points, polylines and segments into whatever framebuffer is bound,
+// a window's or an offscreen one. Each layer is a single draw call.
+// Needs a current GL context.
+class GeometryRenderer {
+  public:
+    // Frames the [0, gridHeight] square for a viewport of the given size.
+    explicit GeometryRenderer(const Vector2i& viewportSize,
+                              int gridHeight = 10);
+
+    // Frames the box from min to max instead, centred with a margin and
+    // keeping the viewport's aspect ratio. Points are drawn at a size
+    // relative to the box.
+    void setView(const Vector2& min, const Vector2& max);
+
+    void renderAxis();
+    void renderPoints(Containers::ArrayView<const Vector2> points,
+                      const Color3& color);
+    void renderPoints(Containers::ArrayView<const Vector3> points,
+                      const Color3& color);
+    // Level of detail for large point sets: the points one by one while at
+    // most maxPoints of them are in view, otherwise the density grid as a
+    // texture, from the level with cells closest to a pixel. Framing a
+    // smaller box with setView() switches back to single points once
+    // there are few enough to tell apart.
+    void renderPointsLod(Containers::ArrayView<const Vector2> points,
+                         const DensityPyramid& density, const Color3& color,
+                         std::size_t maxPoints = LodMaxPoints);
+    void render2DGridOfPoints(int step = 1);
+    void renderPolyLine(Containers::ArrayView<const Vector2> polyLine,
+                        const Color3& color);
+    void renderSegs2(Containers::ArrayView<const Seg2> segs,
+                     const Color3& color);
+
+  private:
+    // Per instance attributes of the instanced meshes, as in BulletExample.
+    struct InstanceData {
+        Matrix4 transformationMatrix;
+        Matrix3x3 normalMatrix;
+        Color3 color;
+    };
+
+    Vector3 toScene(const Vector3& point) const;
+    void addPointInstance(const Vector3& point, float scale,
+                          const Color3& color);
+    void addLineInstance(const Vector2& start, const Vector2& end,
+                         const Color3& color);
+    void drawInstances(GL::Mesh& mesh, GL::Buffer& buffer);
+
+    Vector2 viewportSize_;
+    int gridHeight_;
+    Vector2 centre_;
+    float viewHeight_ = 0.0f;
+    // Visible size of the view, margin included.
+    Vector2 viewSize_;
+    Matrix4 projection_;
+
+    GL::Mesh axis_{NoCreate};
+    Shaders::Phong shader_;
+
+    // Density grids are drawn as a textured square behind everything else.
+    GL::Mesh quad_{NoCreate};
+    GL::Texture2D densityTexture_{NoCreate};
+    Shaders::Flat3D textureShader_;
+    std::vector<std::uint32_t> visible_;
+    std::vector<Vector2> visiblePoints_;
+
+    // Points and segments are drawn one layer per call, with the squares
+    // and unit lines instanced from these buffers.
+    GL::Mesh point_{NoCreate};
+    GL::Mesh line_{NoCreate};
+    GL::Buffer pointInstanceBuffer_;
+    GL::Buffer lineInstanceBuffer_;
+    Shaders::Phong instancedShader_;
+    std::vector<InstanceData> instances_;
+};
+
+} // namespace CompGeom
+
+#endif
@@ -0,0 +1,318 @@
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/OpenGLTester.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Image.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
+
+#include "core/CompGeomCore.h"
+#include "render/GeometryRenderer.h"
+
+namespace CompGeom {
+namespace Test {
+namespace {
+
+// Draws one layer at a time the way comp_geom_headless does and checks the
+// pixels without reference images: which ones are lit, how many, and the
+// dominant channel where a point of a known color is. The shading itself
+// isn't checked, it differs between drivers.
+struct GeometryRendererGLTest : GL::OpenGLTester {
+    explicit GeometryRendererGLTest();
+
+    void empty();
+    void points();
+    void polyLine();
+    void segments();
+    void pointsLodDensity();
+
+  private:
+    // Clears a framebuffer of size_ to the background, frames the view
+    // square, draws into it and reads it back.
+    template <class Draw> Image2D render(Draw draw);
+
+    // The pixel the view point p falls in.
+    Vector2i pixel(const Vector2& p) const;
+    // The view point at the centre of a pixel.
+    Vector2 point(const Vector2i& pixel) const;
+    // Side of a pixel in the view.
+    float pixelSize() const { return viewSize_ * 1.1f / float(size_.y()); }
+
+    // Anything that isn't the background.
+    static bool lit(const Color4ub& color);
+    std::size_t litCount(const Image2D& image) const;
+    // Lit pixels more than a pixel outside the view square.
+    std::size_t litOutside(const Image2D& image) const;
+    // A lit pixel at most one pixel away, lines may step past the exact
+    // one.
+    bool litNear(const Image2D& image, const Vector2i& at) const;
+    // The red, green or blue channel is the largest of the pixel's.
+    static bool dominant(const Color4ub& color, int channel);
+
+    // The larger extent of a segment in pixels, which is about how many
+    // pixels a line of one pixel width lights.
+    float pixelLength(const Vector2& start, const Vector2& end) const;
+
+    Vector2i size_{128, 128};
+    float viewSize_ = 10.0f;
+};
+
+// Clear color, transparent so even a black fragment counts as lit.
+const Color4ub Background{0, 0, 0, 0};
+
+GeometryRendererGLTest::GeometryRendererGLTest() {
+    addTests({&GeometryRendererGLTest::empty, &GeometryRendererGLTest::points,
+              &GeometryRendererGLTest::polyLine,
+              &GeometryRendererGLTest::segments,
+              &GeometryRendererGLTest::pointsLodDensity});
+}
+
+template <class Draw> Image2D GeometryRendererGLTest::render(Draw draw) {
+    GL::Renderbuffer color, depth;
+    color.setStorage(GL::RenderbufferFormat::RGBA8, size_);
+    depth.setStorage(GL::RenderbufferFormat::DepthComponent24, size_);
+    GL::Framebuffer framebuffer{{{}, size_}};
+    GL::Renderer::setClearColor(Color4{0.0f, 0.0f, 0.0f, 0.0f});
+    framebuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, color)
+        .attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth, depth)
+        .clear(GL::FramebufferClear::Color | GL::FramebufferClear::Depth)
+        .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+    GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+    GeometryRenderer renderer{size_};
+    renderer.setView({0.0f, 0.0f}, {viewSize_, viewSize_});
+    draw(renderer);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    return framebuffer.read(framebuffer.viewport(), {PixelFormat::RGBA8Unorm});
+}
+
+// setView() adds a margin of a twentieth of the view on each side.
+Vector2i GeometryRendererGLTest::pixel(const Vector2& p) const {
+    const Vector2 scaled = (p + Vector2{viewSize_ / 20.0f}) / pixelSize();
+    return Vector2i{Int(std::floor(scaled.x())), Int(std::floor(scaled.y()))};
+}
+
+Vector2 GeometryRendererGLTest::point(const Vector2i& pixel) const {
+    return (Vector2{pixel} + Vector2{0.5f}) * pixelSize() -
+           Vector2{viewSize_ / 20.0f};
+}
+
+bool GeometryRendererGLTest::lit(const Color4ub& color) {
+    return color != Background;
+}
+
+std::size_t GeometryRendererGLTest::litCount(const Image2D& image) const {
+    const auto pixels = image.pixels<Color4ub>();
+    std::size_t count = 0;
+    for (Int y = 0; y != size_.y(); ++y) {
+        for (Int x = 0; x != size_.x(); ++x)
+            count += lit(pixels[y][x]);
+    }
+    return count;
+}
+
+std::size_t GeometryRendererGLTest::litOutside(const Image2D& image) const {
+    const auto pixels = image.pixels<Color4ub>();
+    std::size_t count = 0;
+    for (Int y = 0; y != size_.y(); ++y) {
+        for (Int x = 0; x != size_.x(); ++x) {
+            const Vector2 p = point({x, y});
+            const float outside = pixelSize();
+            if (lit(pixels[y][x]) &&
+                (p.min() < -outside || p.max() > viewSize_ + outside))
+                ++count;
+        }
+    }
+    return count;
+}
+
+bool GeometryRendererGLTest::litNear(const Image2D& image,
+                                     const Vector2i& at) const {
+    const auto pixels = image.pixels<Color4ub>();
+    for (Int y = Math::max(at.y() - 1, 0);
+         y <= Math::min(at.y() + 1, size_.y() - 1); ++y) {
+        for (Int x = Math::max(at.x() - 1, 0);
+             x <= Math::min(at.x() + 1, size_.x() - 1); ++x) {
+            if (lit(pixels[y][x]))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool GeometryRendererGLTest::dominant(const Color4ub& color, int channel) {
+    for (int i = 0; i != 3; ++i) {
+        if (i != channel && color[i] >= color[channel])
+            return false;
+    }
+    return true;
+}
+
+float GeometryRendererGLTest::pixelLength(const Vector2& start,
+                                          const Vector2& end) const {
+    return Math::abs(end - start).max() / pixelSize();
+}
+
+void GeometryRendererGLTest::empty() {
+    Image2D image = render([](GeometryRenderer& renderer) {
+        renderer.renderPoints(Containers::ArrayView<const Vector2>{},
+                              Color3(1.0f, 0.0f, 0.0f));
+        renderer.renderSegs2(Containers::ArrayView<const Seg2>{},
+                             Color3(1.0f, 0.0f, 0.0f));
+    });
+    CORRADE_COMPARE(litCount(image), std::size_t(0));
+}
+
+// A grid of red, green and blue points, well apart. A point is a square a
+// bit over a pixel wide, so it lights the pixel its centre is in and at
+// most three more.
+void GeometryRendererGLTest::points() {
+    const Color3 colors[]{Color3(1.0f, 0.0f, 0.0f), Color3(0.0f, 1.0f, 0.0f),
+                          Color3(0.0f, 0.0f, 1.0f)};
+    std::vector<Vector2> layers[3];
+    for (int i = 0; i != 10; ++i) {
+        for (int j = 0; j != 10; ++j)
+            layers[(i + j) % 3].emplace_back(float(i) + 0.5f,
+                                             float(j) + 0.5f);
+    }
+
+    for (int channel = 0; channel != 3; ++channel) {
+        const std::vector<Vector2>& layer = layers[channel];
+        Image2D image = render([&](GeometryRenderer& renderer) {
+            renderer.renderPoints(layer, colors[channel]);
+        });
+
+        const auto pixels = image.pixels<Color4ub>();
+        for (const Vector2& p : layer) {
+            const Vector2i at = pixel(p);
+            CORRADE_VERIFY(lit(pixels[at.y()][at.x()]));
+            CORRADE_VERIFY(dominant(pixels[at.y()][at.x()], channel));
+        }
+        CORRADE_VERIFY(litCount(image) >= layer.size());
+        CORRADE_VERIFY(litCount(image) <= 4 * layer.size());
+        CORRADE_COMPARE(litOutside(image), std::size_t(0));
+    }
+}
+
+// The hull as a closed line, which passes through every hull vertex and
+// lights about as many pixels as its length in pixels.
+void GeometryRendererGLTest::polyLine() {
+    std::vector<Vector2> points(500);
+    generatePoints(points, PointDistribution::GaussianClusters, 7, viewSize_,
+                   1);
+    std::vector<Vector2> hull = computeConvexHull2D(points);
+    CORRADE_VERIFY(hull.size() >= 3);
+    if (hull.front() != hull.back())
+        hull.push_back(hull.front());
+
+    Image2D image = render([&](GeometryRenderer& renderer) {
+        renderer.renderPolyLine(hull, Color3(0.0f, 0.5f, 1.0f));
+    });
+
+    float length = 0.0f;
+    for (std::size_t i = 1; i != hull.size(); ++i) {
+        CORRADE_VERIFY(litNear(image, pixel(hull[i])));
+        length += pixelLength(hull[i - 1], hull[i]);
+    }
+    const float edges = float(hull.size() - 1);
+    CORRADE_VERIFY(float(litCount(image)) >= length - 2.0f * edges);
+    CORRADE_VERIFY(float(litCount(image)) <= length + 2.0f * edges);
+    CORRADE_COMPARE(litOutside(image), std::size_t(0));
+}
+
+// The segments and their intersections as separate layers. Crossing lines
+// share a pixel or two, so the segments light fewer pixels the more
+// intersections there are.
+void GeometryRendererGLTest::segments() {
+    std::vector<Seg2> segments(60, Seg2{Vector2{}, Vector2{}});
+    generateSegments(segments, SegmentDistribution::Uniform, 7, viewSize_, 1);
+    const std::vector<Vector2> intersections =
+        findIntersectingSegmentsSweep(segments);
+    CORRADE_VERIFY(!intersections.empty());
+
+    Image2D lines = render([&](GeometryRenderer& renderer) {
+        renderer.renderSegs2(segments, Color3(0.5f, 0.5f, 0.5f));
+    });
+    float length = 0.0f;
+    for (const Seg2& seg : segments) {
+        length += pixelLength(seg.p, seg.q);
+        // A line under a pixel or so may light nothing at all.
+        if (pixelLength(seg.p, seg.q) < 2.0f)
+            continue;
+        CORRADE_VERIFY(litNear(lines, pixel(seg.p)));
+        CORRADE_VERIFY(litNear(lines, pixel(seg.q)));
+        CORRADE_VERIFY(litNear(lines, pixel((seg.p + seg.q) / 2.0f)));
+    }
+    const float count = float(segments.size());
+    const float shared = 2.0f * float(intersections.size());
+    CORRADE_VERIFY(float(litCount(lines)) >= length - 2.0f * count - shared);
+    CORRADE_VERIFY(float(litCount(lines)) <= length + 2.0f * count);
+    CORRADE_COMPARE(litOutside(lines), std::size_t(0));
+
+    Image2D points = render([&](GeometryRenderer& renderer) {
+        renderer.renderPointsLod(intersections, DensityPyramid{intersections},
+                                 Color3(1.0f, 0.0f, 0.0f));
+    });
+    const auto pixels = points.pixels<Color4ub>();
+    for (const Vector2& p : intersections) {
+        const Vector2i at = pixel(p);
+        CORRADE_VERIFY(lit(pixels[at.y()][at.x()]));
+        CORRADE_VERIFY(dominant(pixels[at.y()][at.x()], 0));
+    }
+    CORRADE_VERIFY(litCount(points) <= 4 * intersections.size());
+    CORRADE_COMPARE(litOutside(points), std::size_t(0));
+}
+
+// Two dense clusters drawn as the density texture. Empty cells are
+// transparent black, the same as the background, so only the pixels
+// around the clusters are lit.
+void GeometryRendererGLTest::pointsLodDensity() {
+    std::vector<Vector2> points(2000);
+    generatePoints(points, PointDistribution::Uniform, 7, 1.0f, 1);
+    for (std::size_t i = 0; i != points.size(); ++i)
+        points[i] += i % 2 ? Vector2{1.5f, 1.5f} : Vector2{7.5f, 7.5f};
+
+    Image2D image = render([&](GeometryRenderer& renderer) {
+        renderer.renderPointsLod(points, DensityPyramid{points},
+                                 Color3(1.0f, 0.0f, 0.0f), 0);
+    });
+
+    const auto pixels = image.pixels<Color4ub>();
+    for (const Vector2 centre : {Vector2{2.0f, 2.0f}, Vector2{8.0f, 8.0f}}) {
+        const Vector2i at = pixel(centre);
+        CORRADE_VERIFY(lit(pixels[at.y()][at.x()]));
+        CORRADE_VERIFY(dominant(pixels[at.y()][at.x()], 0));
+    }
+    const Vector2i middle = pixel(Vector2{5.0f, 5.0f});
+    CORRADE_VERIFY(!lit(pixels[middle.y()][middle.x()]));
+
+    // Nothing lit further from the clusters than a cell of the level
+    // drawn, which is less than two pixels.
+    const float slack = 0.5f + 2.0f * pixelSize();
+    const auto nearCluster = [&](const Vector2& p, const Vector2& centre) {
+        return Math::abs(p - centre).max() <= slack;
+    };
+    for (Int y = 0; y != size_.y(); ++y) {
+        for (Int x = 0; x != size_.x(); ++x) {
+            const Vector2 p = point({x, y});
+            if (lit(pixels[y][x]))
+                CORRADE_VERIFY(nearCluster(p, Vector2{2.0f}) ||
+                               nearCluster(p, Vector2{8.0f}));
+        }
+    }
+}
+
+} // namespace
+} // namespace Test
+} // namespace CompGeom
+
+MAGNUM_GL_TEST_MAIN(CompGeom::Test::GeometryRendererGLTest)